@@ -0,0 +1,83 @@
+#include "async_search.h"
+
+AsyncSearch::~AsyncSearch() {
+    cancel();
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wakeUp.notify_all();
+        worker.join();
+    }
+}
+
+void AsyncSearch::start(const Position& position, const SearchLimits& limits, ProgressCallback onProgress, FinishedCallback onFinished) {
+    cancel();
+    stopRequested.store(false);
+    finished.store(false);
+
+    if (!worker.joinable()) {
+        worker = std::thread([this]() { workerLoop(); });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = Job{ position, limits, std::move(onProgress), std::move(onFinished) };
+        hasJob = true;
+    }
+    running = true;
+    wakeUp.notify_all();
+}
+
+void AsyncSearch::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeUp.wait(lock, [this]() { return quit || hasJob; });
+        if (quit) {
+            return;
+        }
+        Job current = std::move(job);
+        lock.unlock();
+
+        Move bestMove = findBestMove(current.position, current.limits, &stopRequested, current.onProgress);
+        result = bestMove;
+        finished.store(true, std::memory_order_release);
+        if (current.onFinished) {
+            current.onFinished(bestMove);
+        }
+
+        lock.lock();
+        hasJob = false;
+        wakeUp.notify_all();
+    }
+}
+
+void AsyncSearch::stop() {
+    stopRequested.store(true, std::memory_order_relaxed);
+}
+
+void AsyncSearch::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    wakeUp.wait(lock, [this]() { return !hasJob; });
+}
+
+void AsyncSearch::cancel() {
+    stop();
+    wait();
+    running = false;
+    finished.store(false);
+}
+
+bool AsyncSearch::isRunning() const {
+    return running;
+}
+
+bool AsyncSearch::takeResult(Move& move) {
+    if (!running || !finished.load(std::memory_order_acquire)) {
+        return false;
+    }
+    wait();
+    running = false;
+    move = result;
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "search.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs findBestMove() on a worker thread, so a GUI can keep handling events while the AI thinks.
+// The worker searches its own copy of the position, the caller applies the result on its own thread.
+// One worker serves every search of the object, so its thread_local pawn table and move ordering heuristics
+// are still filled from the previous move when the next search starts
+class AsyncSearch {
+public:
+    using FinishedCallback = std::function<void(Move)>;
+
+    AsyncSearch() = default;
+    AsyncSearch(const AsyncSearch&) = delete;
+    AsyncSearch& operator=(const AsyncSearch&) = delete;
+    ~AsyncSearch();
+
+    // Cancels a search that is still running. onProgress and onFinished are called on the worker thread,
+    // onFinished with the best move once the search has ended
+    void start(const Position& position, const SearchLimits& limits, ProgressCallback onProgress = {}, FinishedCallback onFinished = {});
+
+    // Asks the worker to finish early, the best move found so far still becomes the result
+    void stop();
+
+    // Blocks until the worker has finished the current search, the result can still be taken
+    void wait();
+
+    // Stops the worker, waits for it and throws the result away
+    void cancel();
+
+    // True from start() until the result has been taken or the search was cancelled
+    bool isRunning() const;
+
+    // Returns true once, when the search has finished, and hands over its best move
+    bool takeResult(Move& move);
+
+private:
+    struct Job {
+        Position position;
+        SearchLimits limits;
+        ProgressCallback onProgress;
+        FinishedCallback onFinished;
+    };
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    Job job;
+    bool hasJob = false;     // start() handed over a job the worker has not finished yet
+    bool quit = false;
+    bool running = false;    // a search was started and its result not taken, only used by the caller's thread
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> finished{ false };
+    Move result;
+
+    void workerLoop();
+};
@@ -0,0 +1,134 @@
+#include "attacks.h"
+#include <vector>
+
+std::array<Magic, 64> bishopMagics;
+std::array<Magic, 64> rookMagics;
+std::array<std::array<Bitboard, 64>, 64> betweenTable;
+std::array<std::array<Bitboard, 64>, 64> lineTable;
+
+// Sum over all squares of 2^(relevant occupancy bits) for each slider
+static std::array<Bitboard, 5248> bishopTable;
+static std::array<Bitboard, 102400> rookTable;
+
+static constexpr int bishopDirections[4][2] = { {1, 1}, {-1, -1}, {1, -1}, {-1, 1} };
+static constexpr int rookDirections[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+// Walks every direction until the edge of the board or the first occupied square, which is included.
+// Only used to fill the tables
+static Bitboard slidingAttacks(int square, Bitboard occupied, const int (&directions)[4][2]) {
+    Bitboard attacks = 0;
+    for (const auto& direction : directions) {
+        int file = fileOf(square) + direction[0];
+        int rank = rankOf(square) + direction[1];
+        while (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+            attacks |= squareBit(squareOf(file, rank));
+            if (occupied & squareBit(squareOf(file, rank))) break;
+            file += direction[0];
+            rank += direction[1];
+        }
+    }
+    return attacks;
+}
+
+#if !defined(CHESSVSAI_USE_PEXT)
+// xorshift64* generator with a fixed seed, so the magics found are the same on every run
+static Bitboard nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+// Magic candidates with few set bits are much more likely to be good
+static Bitboard sparseRandom(uint64_t& state) {
+    return nextRandom(state) & nextRandom(state) & nextRandom(state);
+}
+#endif
+
+static void initMagics(std::array<Magic, 64>& magics, Bitboard* table, const int (&directions)[4][2]) {
+    constexpr Bitboard rank1 = 0xFFULL;
+    constexpr Bitboard rank8 = rank1 << 56;
+    constexpr Bitboard fileA = 0x0101010101010101ULL;
+    constexpr Bitboard fileH = fileA << 7;
+
+    std::vector<Bitboard> occupancies(4096);
+    std::vector<Bitboard> reference(4096);
+#if !defined(CHESSVSAI_USE_PEXT)
+    // Seeds per rank that are known to find all magics after few attempts
+    constexpr uint64_t seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+    std::vector<int> epoch(4096, 0);
+    int attempt = 0;
+#endif
+
+    Bitboard* next = table;
+    for (int square = 0; square < 64; ++square) {
+        Magic& magic = magics[square];
+
+        // Pieces on the board edge never block anything behind them, so they are left out of the index
+        Bitboard edges = ((rank1 | rank8) & ~(rank1 << (8 * rankOf(square)))) | ((fileA | fileH) & ~(fileA << fileOf(square)));
+        magic.mask = slidingAttacks(square, 0, directions) & ~edges;
+        magic.shift = 64 - std::popcount(magic.mask);
+        magic.attacks = next;
+
+        // Enumerate every subset of the mask with the carry-rippler trick
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            reference[size] = slidingAttacks(square, subset, directions);
+            ++size;
+            subset = (subset - magic.mask) & magic.mask;
+        } while (subset);
+
+#if defined(CHESSVSAI_USE_PEXT)
+        for (int i = 0; i < size; ++i) {
+            magic.attacks[magic.index(occupancies[i])] = reference[i];
+        }
+#else
+        // Try random magics until one maps every occupancy to an index without destructive collisions
+        uint64_t state = seeds[rankOf(square)];
+        bool found = false;
+        while (!found) {
+            do {
+                magic.magic = sparseRandom(state);
+            } while (std::popcount((magic.magic * magic.mask) >> 56) < 6);
+
+            ++attempt;
+            found = true;
+            for (int i = 0; i < size; ++i) {
+                unsigned index = magic.index(occupancies[i]);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    magic.attacks[index] = reference[i];
+                }
+                else if (magic.attacks[index] != reference[i]) {
+                    found = false;
+                    break;
+                }
+            }
+        }
+#endif
+
+        next += size;
+    }
+}
+
+void initAttacks() {
+    initMagics(bishopMagics, bishopTable.data(), bishopDirections);
+    initMagics(rookMagics, rookTable.data(), rookDirections);
+
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            betweenTable[from][to] = 0;
+            lineTable[from][to] = 0;
+            if (bishopAttacks(from, 0) & squareBit(to)) {
+                betweenTable[from][to] = bishopAttacks(from, squareBit(to)) & bishopAttacks(to, squareBit(from));
+                lineTable[from][to] = (bishopAttacks(from, 0) & bishopAttacks(to, 0)) | squareBit(from) | squareBit(to);
+            }
+            else if (rookAttacks(from, 0) & squareBit(to)) {
+                betweenTable[from][to] = rookAttacks(from, squareBit(to)) & rookAttacks(to, squareBit(from));
+                lineTable[from][to] = (rookAttacks(from, 0) & rookAttacks(to, 0)) | squareBit(from) | squareBit(to);
+            }
+        }
+    }
+}
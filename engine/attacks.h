@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <cstddef>
+
+#if defined(CHESSVSAI_USE_PEXT)
+#include <immintrin.h>
+#endif
+
+// Attack sets of a knight, a king and a pawn of each player from every square, built at compile time
+template <std::size_t N>
+constexpr std::array<Bitboard, 64> makeStepAttackTable(const int (&steps)[N][2]) {
+    std::array<Bitboard, 64> table{};
+    for (int square = 0; square < 64; ++square) {
+        for (const auto& step : steps) {
+            int file = fileOf(square) + step[0];
+            int rank = rankOf(square) + step[1];
+            if (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+                table[square] |= squareBit(squareOf(file, rank));
+            }
+        }
+    }
+    return table;
+}
+
+constexpr int knightSteps[8][2] = { {1, 2}, {2, 1}, {-1, 2}, {-2, 1}, {1, -2}, {2, -1}, {-1, -2}, {-2, -1} };
+constexpr int kingSteps[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1} };
+constexpr int whitePawnSteps[2][2] = { {-1, 1}, {1, 1} };
+constexpr int blackPawnSteps[2][2] = { {-1, -1}, {1, -1} };
+
+constexpr std::array<Bitboard, 64> knightAttackTable = makeStepAttackTable(knightSteps);
+constexpr std::array<Bitboard, 64> kingAttackTable = makeStepAttackTable(kingSteps);
+constexpr std::array<std::array<Bitboard, 64>, 2> pawnAttackTable = { makeStepAttackTable(whitePawnSteps), makeStepAttackTable(blackPawnSteps) };
+
+// Slider attacks are looked up in precomputed tables. The relevant occupancy is turned into a table index either by
+// magic multiplication or, when built with CHESSVSAI_USE_PEXT on a BMI2 capable CPU, by a single PEXT instruction
+struct Magic {
+    Bitboard mask = 0;
+    Bitboard magic = 0;
+    Bitboard* attacks = nullptr;
+    int shift = 0;
+
+    unsigned index(Bitboard occupied) const {
+#if defined(CHESSVSAI_USE_PEXT)
+        return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+extern std::array<Magic, 64> bishopMagics;
+extern std::array<Magic, 64> rookMagics;
+extern std::array<std::array<Bitboard, 64>, 64> betweenTable;
+extern std::array<std::array<Bitboard, 64>, 64> lineTable;
+
+// Fills the slider tables, must be called once before any attack lookup
+void initAttacks();
+
+inline Bitboard knightAttacks(int square) {
+    return knightAttackTable[square];
+}
+
+inline Bitboard kingAttacks(int square) {
+    return kingAttackTable[square];
+}
+
+inline Bitboard pawnAttacks(Player player, int square) {
+    return pawnAttackTable[static_cast<int>(player)][square];
+}
+
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+    const Magic& magic = bishopMagics[square];
+    return magic.attacks[magic.index(occupied)];
+}
+
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+    const Magic& magic = rookMagics[square];
+    return magic.attacks[magic.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+}
+
+// Squares strictly between two squares on the same line, empty if they do not share a line
+inline Bitboard betweenSquares(int from, int to) {
+    return betweenTable[from][to];
+}
+
+// The whole line from edge to edge through both squares, empty if they do not share a line
+inline Bitboard lineThrough(int from, int to) {
+    return lineTable[from][to];
+}
+
+inline Bitboard attacksFrom(PieceType type, Player player, int square, Bitboard occupied) {
+    switch (type) {
+    case PieceType::Pawn: return pawnAttacks(player, square);
+    case PieceType::Knight: return knightAttacks(square);
+    case PieceType::Bishop: return bishopAttacks(square, occupied);
+    case PieceType::Rook: return rookAttacks(square, occupied);
+    case PieceType::Queen: return queenAttacks(square, occupied);
+    case PieceType::King: return kingAttacks(square);
+    default: return 0;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "move.h"
+#include "position.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Opening book in the Polyglot .bin format, looked up before the search starts.
+// The file is memory-mapped, not read into the heap: its entries of 16 bytes are sorted by key, so a position is found
+// by binary search right in the mapping. Polyglot keys use their own 781 random numbers (Random64 in the Polyglot sources),
+// which are compiled in
+class OpeningBook {
+public:
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+    ~OpeningBook();
+
+    // Throws std::runtime_error if the file can not be read
+    void open(const std::string& bookPath);
+    void close();
+    bool isOpen() const { return entryCount > 0; }
+
+    static uint64_t polyglotKey(const Position& position);
+
+    // A legal book move of the side to move, chosen at random in proportion to the entry weights, or an empty move
+    Move probe(const Position& position) const;
+
+private:
+    const unsigned char* entries = nullptr;
+    size_t entryCount = 0;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+};
+
+// Used by aiMakeMove() and the GUI, it stays closed unless a book is opened
+extern OpeningBook openingBook;
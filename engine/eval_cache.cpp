@@ -0,0 +1,21 @@
+#include "eval_cache.h"
+#include <algorithm>
+#include <bit>
+
+EvalCache::EvalCache(size_t megabytes) {
+    resize(megabytes);
+}
+
+// The number of entries is rounded down to a power of two, so a key can be mapped to an entry with a mask
+void EvalCache::resize(size_t megabytes) {
+    entryCount = std::bit_floor(std::max<size_t>(1, megabytes * 1024 * 1024 / sizeof(std::atomic<uint64_t>)));
+    entries = std::make_unique<std::atomic<uint64_t>[]>(entryCount);
+    clear();
+}
+
+// Empty entries get an upper key half of all ones, so they are not mistaken for positions whose key starts with zeros
+void EvalCache::clear() {
+    for (size_t i = 0; i < entryCount; ++i) {
+        entries[i].store(0xFFFFFFFF00000000ULL, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Direct-mapped cache of static evaluations, indexed by the Zobrist key of the position.
+// An entry is one 64 bit word holding the upper half of the key and the score, so threads read and write it
+// without locks and can never see the score of one position paired with the key of another
+class EvalCache {
+public:
+    explicit EvalCache(size_t megabytes = 2);
+
+    void resize(size_t megabytes);
+    void clear();
+
+    bool probe(uint64_t key, int& score) const {
+        uint64_t entry = entries[key & (entryCount - 1)].load(std::memory_order_relaxed);
+        if ((entry ^ key) >> 32) {
+            return false;
+        }
+        score = static_cast<int32_t>(static_cast<uint32_t>(entry));
+        return true;
+    }
+
+    void store(uint64_t key, int score) {
+        entries[key & (entryCount - 1)].store((key & 0xFFFFFFFF00000000ULL) | static_cast<uint32_t>(score), std::memory_order_relaxed);
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> entries;
+    size_t entryCount = 0;
+};
@@ -0,0 +1,76 @@
+#include "evaluate.h"
+#include "attacks.h"
+#include "pawns.h"
+#include "psqt.h"
+#include "rules.h"
+#include <algorithm>
+
+int getPieceValue(PieceType piece) {
+    switch (piece) {
+    case PieceType::Pawn: return 100;
+    case PieceType::Knight: return 320;
+    case PieceType::Bishop: return 330;
+    case PieceType::Rook: return 500;
+    case PieceType::Queen: return 900;
+    case PieceType::King: return 20000;
+    default: return 0;
+    }
+}
+
+int pieceSquareValue(PieceType type, Player player, int square) {
+    return pieceSquareTableValue(type, player, square);
+}
+
+// A piece hangs when a cheaper enemy piece attacks it or when it is attacked and not defended at all.
+// The penalty is a tenth of the piece value, the exchange itself is left to the quiescence search
+static int hangingPenalty(const Position& position, Player player) {
+    const AttackInfo& info = attackInfo(position);
+    int side = static_cast<int>(player);
+    int enemy = static_cast<int>(getOppositePlayer(player));
+    Bitboard pieces = position.occupancy[side] & ~piecesOf(position, player, PieceType::King);
+    Bitboard pawns = piecesOf(position, player, PieceType::Pawn);
+    Bitboard heavyPieces = piecesOf(position, player, PieceType::Rook) | piecesOf(position, player, PieceType::Queen);
+
+    Bitboard hanging = (pieces & ~pawns & info.byPawns[enemy])
+        | (heavyPieces & info.byMinors[enemy])
+        | (piecesOf(position, player, PieceType::Queen) & info.byRooks[enemy])
+        | (pieces & info.attacked[enemy] & ~info.attacked[side]);
+
+    int penalty = 0;
+    while (hanging) {
+        penalty += getPieceValue(pieceAt(position, popLsb(hanging))) / 10;
+    }
+    return penalty;
+}
+
+// A passed pawn whose square in front is empty is worth more in the endgame, the closer it is to promotion the more
+static Score freePassedPawns(const Position& position, Player player, Bitboard passed) {
+    Bitboard empty = ~occupiedSquares(position);
+    Score score = 0;
+    while (passed) {
+        int square = popLsb(passed);
+        int stop = player == Player::White ? square + 8 : square - 8;
+        int relativeRank = player == Player::White ? rankOf(square) : 7 - rankOf(square);
+        if (empty & squareBit(stop)) score += makeScore(0, 3 * relativeRank);
+    }
+    return score;
+}
+
+// This function calculates a numerical score that represents the value of a given position, positive when White is better.
+// Material and piece-square values are summed up incrementally while pieces move, as a middlegame and an endgame score.
+// The pawn structure and the pawn shields of the kings come from the pawn hash table, which only evaluates them
+// for pawn configurations it has not seen yet.
+// The result blends the middlegame and endgame scores by the game phase, so the evaluation shifts smoothly towards the endgame
+// as pieces come off. Pieces left hanging are penalized on top of that
+int evaluatePosition(const Position& position) {
+    PawnEntry& pawns = pawnTable().probe(position);
+    Score total = position.psqtScore + pawns.score
+        + kingShelter(pawns, position, Player::White) - kingShelter(pawns, position, Player::Black)
+        + freePassedPawns(position, Player::White, pawns.passed[0]) - freePassedPawns(position, Player::Black, pawns.passed[1]);
+
+    int phase = std::min(position.phase, totalPhase);
+    int score = (mgValue(total) * phase + egValue(total) * (totalPhase - phase)) / totalPhase;
+    score -= hangingPenalty(position, Player::White);
+    score += hangingPenalty(position, Player::Black);
+    return score;
+}
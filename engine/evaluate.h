@@ -0,0 +1,8 @@
+#pragma once
+
+#include "position.h"
+
+int getPieceValue(PieceType piece);
+int pieceSquareValue(PieceType type, Player player, int square);
+
+int evaluatePosition(const Position& position);
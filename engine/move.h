@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+
+enum MoveFlag : uint16_t {
+    Quiet = 0,
+    DoublePawnPush = 1,
+    KingCastle = 2,
+    QueenCastle = 3,
+    Capture = 4,
+    EnPassant = 5,
+    KnightPromotion = 8,
+    BishopPromotion = 9,
+    RookPromotion = 10,
+    QueenPromotion = 11,
+    KnightPromotionCapture = 12,
+    BishopPromotionCapture = 13,
+    RookPromotionCapture = 14,
+    QueenPromotionCapture = 15
+};
+
+// A move packed into 16 bits: 6 bits start square, 6 bits end square and 4 bits of MoveFlag.
+// Everything needed to take the move back lives in UndoInfo, so a move list stays small enough for the stack
+struct Move {
+    uint16_t data = 0;
+
+    Move() = default;
+    constexpr Move(int from, int to, int flags = Quiet)
+        : data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) {}
+
+    constexpr int from() const { return data & 63; }
+    constexpr int to() const { return (data >> 6) & 63; }
+    constexpr int flags() const { return data >> 12; }
+
+    constexpr bool isNone() const { return data == 0; }
+    constexpr bool isCapture() const { return flags() & Capture; }
+    constexpr bool isPromotion() const { return flags() & KnightPromotion; }
+    constexpr bool isCastle() const { return flags() == KingCastle || flags() == QueenCastle; }
+    constexpr PieceType promotionType() const { return static_cast<PieceType>((flags() & 3) + static_cast<int>(PieceType::Knight)); }
+
+    constexpr bool operator==(const Move& other) const { return data == other.data; }
+};
+
+// State of the position that a move destroys and undoMove() has to restore
+struct UndoInfo {
+    PieceType capturedType = PieceType::Empty;
+    uint8_t castlingRights = 0;
+    uint8_t epSquare = NoSquare;
+    uint16_t halfmoveClock = 0;
+    uint64_t key = 0;
+};
+
+// Fixed capacity list of moves, 256 is more than the maximum number of moves in any legal chess position
+struct MoveList {
+    std::array<Move, 256> moves;
+    int count = 0;
+
+    void add(Move move) { moves[count++] = move; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int index) { return moves[index]; }
+    const Move& operator[](int index) const { return moves[index]; }
+
+    Move* begin() { return moves.data(); }
+    Move* end() { return moves.data() + count; }
+    const Move* begin() const { return moves.data(); }
+    const Move* end() const { return moves.data() + count; }
+};
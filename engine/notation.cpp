@@ -0,0 +1,111 @@
+#include "notation.h"
+#include "rules.h"
+
+std::string squareName(int square) {
+    return { static_cast<char>('a' + fileOf(square)), static_cast<char>('1' + rankOf(square)) };
+}
+
+std::string moveToString(Move move) {
+    std::string text = squareName(move.from()) + squareName(move.to());
+    if (move.isPromotion()) {
+        text += "nbrq"[static_cast<int>(move.promotionType()) - static_cast<int>(PieceType::Knight)];
+    }
+    return text;
+}
+
+Move parseMove(const Position& position, const std::string& text) {
+    if (text.size() < 4 || text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8'
+        || text[2] < 'a' || text[2] > 'h' || text[3] < '1' || text[3] > '8') {
+        return Move();
+    }
+    int from = squareOf(text[0] - 'a', text[1] - '1');
+    int to = squareOf(text[2] - 'a', text[3] - '1');
+
+    PieceType promotion = PieceType::Queen;
+    if (text.size() > 4) {
+        switch (text[4]) {
+        case 'n': promotion = PieceType::Knight; break;
+        case 'b': promotion = PieceType::Bishop; break;
+        case 'r': promotion = PieceType::Rook; break;
+        case 'q': promotion = PieceType::Queen; break;
+        default: return Move();
+        }
+    }
+    return findLegalMove(position, from, to, promotion);
+}
+
+std::string moveToSan(const Position& position, Move move) {
+    std::string text;
+    PieceType type = pieceAt(position, move.from());
+
+    if (move.flags() == KingCastle) {
+        text = "O-O";
+    }
+    else if (move.flags() == QueenCastle) {
+        text = "O-O-O";
+    }
+    else if (type == PieceType::Pawn) {
+        if (move.isCapture()) {
+            text += static_cast<char>('a' + fileOf(move.from()));
+            text += 'x';
+        }
+        text += squareName(move.to());
+        if (move.isPromotion()) {
+            text += '=';
+            text += "NBRQ"[static_cast<int>(move.promotionType()) - static_cast<int>(PieceType::Knight)];
+        }
+    }
+    else {
+        text += "PNBRQK"[static_cast<int>(type)];
+
+        // Another piece of the same type that can reach the same square has to be told apart by file, rank or both
+        MoveList moves;
+        generateAllPossibleMoves(position, position.sideToMove, moves);
+        bool ambiguous = false, sameFile = false, sameRank = false;
+        for (Move other : moves) {
+            if (other.to() == move.to() && other.from() != move.from() && pieceAt(position, other.from()) == type) {
+                ambiguous = true;
+                sameFile |= fileOf(other.from()) == fileOf(move.from());
+                sameRank |= rankOf(other.from()) == rankOf(move.from());
+            }
+        }
+        if (ambiguous) {
+            if (!sameFile) text += static_cast<char>('a' + fileOf(move.from()));
+            else if (!sameRank) text += static_cast<char>('1' + rankOf(move.from()));
+            else text += squareName(move.from());
+        }
+
+        if (move.isCapture()) text += 'x';
+        text += squareName(move.to());
+    }
+
+    Position after = position;
+    makeMove(after, move);
+    if (isKingInCheck(after, after.sideToMove)) {
+        text += hasAnyLegalMove(after, after.sideToMove) ? '+' : '#';
+    }
+    return text;
+}
+
+Move parseSan(const Position& position, const std::string& text) {
+    // Check marks and annotations like "+", "#", "!" or "?" are not part of the comparison
+    std::string san = text;
+    while (!san.empty() && std::string("+#!?").find(san.back()) != std::string::npos) {
+        san.pop_back();
+    }
+    if (san == "0-0") san = "O-O";
+    if (san == "0-0-0") san = "O-O-O";
+
+    MoveList moves;
+    generateAllPossibleMoves(position, position.sideToMove, moves);
+    for (Move move : moves) {
+        std::string candidate = moveToSan(position, move);
+        while (!candidate.empty() && (candidate.back() == '+' || candidate.back() == '#')) {
+            candidate.pop_back();
+        }
+        if (candidate == san) {
+            return move;
+        }
+    }
+    return parseMove(position, text);
+}
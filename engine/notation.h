@@ -0,0 +1,19 @@
+#pragma once
+
+#include "move.h"
+#include "position.h"
+#include <string>
+
+std::string squareName(int square);
+
+// Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q"
+std::string moveToString(Move move);
+
+// Standard algebraic notation as used in PGN, e.g. "Nf3", "exd5", "O-O" or "e8=Q+". The move must be legal in the position
+std::string moveToSan(const Position& position, Move move);
+
+// Finds the legal move of the side to move written in long algebraic notation, an empty move if there is none
+Move parseMove(const Position& position, const std::string& text);
+// Finds the legal move of the side to move written in standard algebraic notation, as in EPD bm and am operations.
+// Long algebraic notation is accepted as well, an empty move is returned if neither matches
+Move parseSan(const Position& position, const std::string& text);
@@ -0,0 +1,145 @@
+#include "ordering.h"
+#include "evaluate.h"
+#include "see.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Ranges of the move scores: the transposition table move comes first, then captures and promotions,
+// the killers, the counter move, the other quiet moves by history, and last the captures that lose material
+static constexpr int ttMoveScore = 2000000;
+static constexpr int captureScore = 1000000;
+static constexpr int killerScore = 900000;
+static constexpr int counterMoveScore = 800000;
+static constexpr int losingCaptureScore = -100000;
+
+// History scores stay within plus and minus this value
+static constexpr int maxHistory = 16384;
+
+void SearchHeuristics::newSearch() {
+    for (auto& plyKillers : killers) {
+        plyKillers.fill(Move());
+    }
+    for (auto& player : history) {
+        for (auto& from : player) {
+            for (int& score : from) {
+                score /= 2;
+            }
+        }
+    }
+}
+
+// Each update moves the score towards plus or minus maxHistory by a share of the remaining distance,
+// so moves that keep causing cutoffs stay on top without the table ever overflowing
+static void updateHistory(int& entry, int bonus) {
+    entry += bonus - entry * std::abs(bonus) / maxHistory;
+}
+
+void SearchHeuristics::updateQuiet(const Position& position, Move best, Move previousMove, int ply, int depth, const MoveList& quietsTried) {
+    int side = static_cast<int>(position.sideToMove);
+    int bonus = std::min(depth * depth, 1200);
+
+    updateHistory(history[side][best.from()][best.to()], bonus);
+    for (Move move : quietsTried) {
+        if (move != best) {
+            updateHistory(history[side][move.from()][move.to()], -bonus);
+        }
+    }
+
+    if (ply < maxPly && killers[ply][0] != best) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = best;
+    }
+
+    if (!previousMove.isNone()) {
+        int opponent = static_cast<int>(getOppositePlayer(position.sideToMove));
+        counterMoves[opponent][static_cast<int>(pieceAt(position, previousMove.to()))][previousMove.to()] = best;
+    }
+}
+
+Move SearchHeuristics::counterMove(const Position& position, Move previousMove) const {
+    if (previousMove.isNone()) {
+        return Move();
+    }
+    int opponent = static_cast<int>(getOppositePlayer(position.sideToMove));
+    return counterMoves[opponent][static_cast<int>(pieceAt(position, previousMove.to()))][previousMove.to()];
+}
+
+// A capture of a piece worth at least the capturing piece can not lose material, the exchange only has to be
+// played out for the others
+bool isLosingCapture(Move move, const Position& position) {
+    if (!move.isCapture() || move.isPromotion() || move.flags() == EnPassant) {
+        return false;
+    }
+    if (getPieceValue(pieceAt(position, move.to())) >= getPieceValue(pieceAt(position, move.from()))) {
+        return false;
+    }
+    return staticExchange(position, move) < 0;
+}
+
+// Captures are ordered most valuable victim first and, between equal victims, least valuable attacker first (MVV-LVA).
+// Promotions count the gained material like a capture. Quiet moves are ordered by how much they improve the piece-square value
+int moveScore(Move move, const Position& position) {
+    PieceType type = pieceAt(position, move.from());
+    if (move.isCapture() || move.isPromotion()) {
+        int gain = move.flags() == EnPassant ? getPieceValue(PieceType::Pawn) : getPieceValue(pieceAt(position, move.to()));
+        if (move.isPromotion()) {
+            gain += getPieceValue(move.promotionType()) - getPieceValue(PieceType::Pawn);
+        }
+        return captureScore + gain * 8 - static_cast<int>(type);
+    }
+    Player player = position.sideToMove;
+    return pieceSquareValue(type, player, move.to()) - pieceSquareValue(type, player, move.from());
+}
+
+// This function is used to sort a list of chess moves based on their expected effectiveness or strategic value.
+// This move ordering is a important thing in chess AI that improves the efficiency of the minimax with alpha-beta pruning
+void orderMoves(MoveList& moves, const Position& position) {
+    MoveScores scores;
+    scoreMoves(moves, position, scores);
+    sortMoves(moves, scores, 0);
+}
+
+void scoreMoves(const MoveList& moves, const Position& position, MoveScores& scores) {
+    for (int i = 0; i < moves.size(); ++i) {
+        scores[i] = moveScore(moves[i], position);
+    }
+}
+
+void scoreMoves(const MoveList& moves, const Position& position, const SearchHeuristics& heuristics, Move ttMove,
+    Move previousMove, int ply, MoveScores& scores) {
+    int side = static_cast<int>(position.sideToMove);
+    Move counter = heuristics.counterMove(position, previousMove);
+    const auto& killers = heuristics.killers[std::min(ply, maxPly - 1)];
+
+    for (int i = 0; i < moves.size(); ++i) {
+        Move move = moves[i];
+        if (move == ttMove) scores[i] = ttMoveScore;
+        else if (isLosingCapture(move, position)) scores[i] = losingCaptureScore + moveScore(move, position) - captureScore;
+        else if (move.isCapture() || move.isPromotion()) scores[i] = moveScore(move, position);
+        else if (move == killers[0]) scores[i] = killerScore;
+        else if (move == killers[1]) scores[i] = killerScore - 1;
+        else if (move == counter) scores[i] = counterMoveScore;
+        else scores[i] = heuristics.history[side][move.from()][move.to()] + moveScore(move, position);
+    }
+}
+
+// Selection sort step: moves the best of the remaining moves to index and returns it.
+// Most nodes cut off after one or two moves, so sorting the whole list up front would mostly be wasted
+Move pickMove(MoveList& moves, MoveScores& scores, int index) {
+    int best = index;
+    for (int i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+    return moves[index];
+}
+
+// Sorts the moves from first on by score, best first
+void sortMoves(MoveList& moves, MoveScores& scores, int first) {
+    for (int i = first; i < moves.size(); ++i) {
+        pickMove(moves, scores, i);
+    }
+}
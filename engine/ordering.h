@@ -0,0 +1,37 @@
+#pragma once
+
+#include "position.h"
+#include <array>
+
+// Deepest ply the per-ply tables have room for
+constexpr int maxPly = 128;
+
+// Scores of the moves of a MoveList index by index, computed once before the moves are picked
+using MoveScores = std::array<int, 256>;
+
+// What one search thread learns about quiet moves while it searches: two killer moves per ply,
+// a history score for every start and end square, and the reply that refuted each previous move
+struct SearchHeuristics {
+    std::array<std::array<Move, 2>, maxPly> killers{};
+    std::array<std::array<std::array<int, 64>, 64>, 2> history{};
+    std::array<std::array<std::array<Move, 64>, 6>, 2> counterMoves{};
+
+    // Killers only make sense for the position they were found in, history is kept at half weight
+    void newSearch();
+
+    // Called when a quiet move caused a cutoff, quietsTried are the quiet moves searched before it without success
+    void updateQuiet(const Position& position, Move best, Move previousMove, int ply, int depth, const MoveList& quietsTried);
+
+    Move counterMove(const Position& position, Move previousMove) const;
+};
+
+bool isLosingCapture(Move move, const Position& position);
+int moveScore(Move move, const Position& position);
+void orderMoves(MoveList& moves, const Position& position);
+
+void scoreMoves(const MoveList& moves, const Position& position, MoveScores& scores);
+void scoreMoves(const MoveList& moves, const Position& position, const SearchHeuristics& heuristics, Move ttMove,
+    Move previousMove, int ply, MoveScores& scores);
+
+Move pickMove(MoveList& moves, MoveScores& scores, int index);
+void sortMoves(MoveList& moves, MoveScores& scores, int first);
@@ -0,0 +1,133 @@
+#include "pawns.h"
+#include "attacks.h"
+#include <algorithm>
+#include <cstdlib>
+
+constexpr Bitboard fileABitboard = 0x0101010101010101ULL;
+
+constexpr Score doubledPenalty = makeScore(10, 20);
+constexpr Score isolatedPenalty = makeScore(10, 15);
+constexpr Score backwardPenalty = makeScore(8, 12);
+
+// Bonus of a passed pawn by its rank as seen from its own side, on top of the advancement bonus of the piece-square tables
+constexpr std::array<Score, 8> passedBonus = {
+    makeScore(0, 0), makeScore(0, 0), makeScore(5, 10), makeScore(10, 15),
+    makeScore(15, 25), makeScore(25, 45), makeScore(40, 80), makeScore(0, 0)
+};
+
+// Penalty of a shield file by the distance of the nearest own pawn in front of the king, 0 when there is none
+constexpr std::array<Score, 3> shieldPenalty = { makeScore(25, 0), makeScore(0, 0), makeScore(10, 0) };
+
+constexpr Bitboard fileBitboard(int file) {
+    return fileABitboard << file;
+}
+
+constexpr Bitboard adjacentFiles(int file) {
+    return (file > 0 ? fileBitboard(file - 1) : 0) | (file < 7 ? fileBitboard(file + 1) : 0);
+}
+
+// Squares of the ranks in front of a square, as seen from the player's side
+static constexpr std::array<std::array<Bitboard, 64>, 2> ranksAhead = [] {
+    std::array<std::array<Bitboard, 64>, 2> masks{};
+    for (int square = 0; square < 64; ++square) {
+        for (int rank = 0; rank < 8; ++rank) {
+            Bitboard rankBits = Bitboard(0xFF) << (8 * rank);
+            if (rank > rankOf(square)) masks[0][square] |= rankBits;
+            if (rank < rankOf(square)) masks[1][square] |= rankBits;
+        }
+    }
+    return masks;
+}();
+
+// Pawns of the player on these squares would stop a pawn from being passed
+static Bitboard passedSpan(int player, int square) {
+    return ranksAhead[player][square] & (fileBitboard(fileOf(square)) | adjacentFiles(fileOf(square)));
+}
+
+// Doubled, isolated, backward and passed pawns of one player, from that player's point of view
+static Score evaluatePawns(const Position& position, Player player, Bitboard& passed) {
+    int side = static_cast<int>(player);
+    Bitboard ownPawns = piecesOf(position, player, PieceType::Pawn);
+    Bitboard enemyPawns = piecesOf(position, getOppositePlayer(player), PieceType::Pawn);
+
+    Score score = 0;
+    Bitboard pawns = ownPawns;
+    while (pawns) {
+        int square = popLsb(pawns);
+        int file = fileOf(square);
+        int relativeRank = player == Player::White ? rankOf(square) : 7 - rankOf(square);
+        Bitboard ahead = ranksAhead[side][square];
+        bool doubled = ownPawns & ahead & fileBitboard(file);
+
+        if (doubled) score -= doubledPenalty;
+
+        // Backward pawns have no neighbour on their rank or behind to support their advance, and an enemy pawn guards the square in front
+        if (!(ownPawns & adjacentFiles(file))) {
+            score -= isolatedPenalty;
+        }
+        else if (!(ownPawns & adjacentFiles(file) & ~ahead)) {
+            int stop = player == Player::White ? square + 8 : square - 8;
+            if (pawnAttackTable[side][stop] & enemyPawns) score -= backwardPenalty;
+        }
+
+        if (!doubled && !(enemyPawns & passedSpan(side, square))) {
+            passed |= squareBit(square);
+            score += passedBonus[relativeRank];
+        }
+    }
+    return score;
+}
+
+// The king is sheltered by own pawns on its file and the two next to it, at best right in front of it
+static Score evaluateShelter(const Position& position, Player player, int king) {
+    int side = static_cast<int>(player);
+    Bitboard pawnsAhead = piecesOf(position, player, PieceType::Pawn) & ranksAhead[side][king];
+    int middleFile = std::clamp(fileOf(king), 1, 6);
+
+    Score score = 0;
+    for (int file = middleFile - 1; file <= middleFile + 1; ++file) {
+        Bitboard shield = pawnsAhead & fileBitboard(file);
+        int distance = 0;
+        if (shield) {
+            int nearest = player == Player::White ? std::countr_zero(shield) : 63 - std::countl_zero(shield);
+            distance = std::min(std::abs(rankOf(nearest) - rankOf(king)), 2);
+        }
+        score -= shieldPenalty[distance];
+    }
+    return score;
+}
+
+PawnTable::PawnTable(size_t entryCount) : entries(entryCount) {
+    // An empty entry has the key and the score of a position without pawns, the shelter is computed on first use
+    for (PawnEntry& entry : entries) {
+        entry.kingSquare = { NoSquare, NoSquare };
+    }
+}
+
+PawnEntry& PawnTable::probe(const Position& position) {
+    PawnEntry& entry = entries[position.pawnKey & (entries.size() - 1)];
+    if (entry.key == position.pawnKey) {
+        return entry;
+    }
+
+    entry.key = position.pawnKey;
+    entry.passed = {};
+    entry.kingSquare = { NoSquare, NoSquare };
+    entry.score = evaluatePawns(position, Player::White, entry.passed[0]) - evaluatePawns(position, Player::Black, entry.passed[1]);
+    return entry;
+}
+
+PawnTable& pawnTable() {
+    thread_local PawnTable table;
+    return table;
+}
+
+Score kingShelter(PawnEntry& entry, const Position& position, Player player) {
+    int side = static_cast<int>(player);
+    int king = kingSquare(position, player);
+    if (entry.kingSquare[side] != king) {
+        entry.kingSquare[side] = king;
+        entry.shelter[side] = evaluateShelter(position, player, king);
+    }
+    return entry.shelter[side];
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "position.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Pawn structure of one position, as cached by the pawn hash table. The score is positive when White's pawns are better
+struct PawnEntry {
+    uint64_t key = 0;
+    Score score = 0;                   // Doubled, isolated, backward and passed pawns
+    std::array<Bitboard, 2> passed{};  // Passed pawns of each player
+    std::array<int, 2> kingSquare{};   // Squares the shelter scores were computed for
+    std::array<Score, 2> shelter{};    // Pawn shield in front of each player's king, from that player's point of view
+};
+
+// Direct-mapped table of pawn structures keyed by Position::pawnKey. Pawn structures repeat far more often than positions,
+// so almost every evaluation in a search finds its pawns here. Each thread has a table of its own and needs no locks
+class PawnTable {
+public:
+    explicit PawnTable(size_t entryCount = 16384);
+
+    // Returns the entry of the position's pawns, evaluating them first on a miss
+    PawnEntry& probe(const Position& position);
+
+private:
+    std::vector<PawnEntry> entries;
+};
+
+// The table of the calling thread
+PawnTable& pawnTable();
+
+// Shelter of the player's king, taken from the entry while the king stays on the square it was computed for
+Score kingShelter(PawnEntry& entry, const Position& position, Player player);
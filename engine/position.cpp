@@ -0,0 +1,326 @@
+#include "position.h"
+#include "attacks.h"
+#include "psqt.h"
+#include "rules.h"
+#include "zobrist.h"
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+// Castling rights that survive a move from or to each square. Touching a king or rook home square clears the matching rights
+static constexpr std::array<uint8_t, 64> castlingMask = [] {
+    std::array<uint8_t, 64> mask{};
+    mask.fill(WhiteKingSide | WhiteQueenSide | BlackKingSide | BlackQueenSide);
+    mask[squareOf(0, 0)] &= ~WhiteQueenSide;
+    mask[squareOf(7, 0)] &= ~WhiteKingSide;
+    mask[squareOf(4, 0)] &= ~(WhiteKingSide | WhiteQueenSide);
+    mask[squareOf(0, 7)] &= ~BlackQueenSide;
+    mask[squareOf(7, 7)] &= ~BlackKingSide;
+    mask[squareOf(4, 7)] &= ~(BlackKingSide | BlackQueenSide);
+    return mask;
+}();
+
+// Builds the Zobrist key from scratch, makeMove() and undoMove() keep it up to date incrementally
+uint64_t computeKey(const Position& position) {
+    uint64_t key = 0;
+    Bitboard pieces = occupiedSquares(position);
+    while (pieces) {
+        int square = popLsb(pieces);
+        key ^= zobrist.pieces[static_cast<int>(playerAt(position, square))][static_cast<int>(pieceAt(position, square))][square];
+    }
+    key ^= zobrist.castling[position.castlingRights];
+    if (position.epSquare != NoSquare) key ^= zobrist.enPassantFile[fileOf(position.epSquare)];
+    if (position.sideToMove == Player::Black) key ^= zobrist.blackToMove;
+    return key;
+}
+
+void clearPosition(Position& position) {
+    position = Position();
+    position.board.fill(PieceType::Empty);
+}
+
+void putPiece(Position& position, Player player, PieceType type, int square) {
+    position.pieces[static_cast<int>(player)][static_cast<int>(type)] |= squareBit(square);
+    position.occupancy[static_cast<int>(player)] |= squareBit(square);
+    position.board[square] = type;
+    position.key ^= zobrist.pieces[static_cast<int>(player)][static_cast<int>(type)][square];
+    if (type == PieceType::Pawn) position.pawnKey ^= zobrist.pieces[static_cast<int>(player)][static_cast<int>(type)][square];
+    position.psqtScore += pieceSquareScores[static_cast<int>(player)][static_cast<int>(type)][square];
+    position.phase += phaseWeights[static_cast<int>(type)];
+}
+
+void removePiece(Position& position, int square) {
+    Player player = playerAt(position, square);
+    if (player == Player::None) return;
+    position.key ^= zobrist.pieces[static_cast<int>(player)][static_cast<int>(position.board[square])][square];
+    if (position.board[square] == PieceType::Pawn) position.pawnKey ^= zobrist.pieces[static_cast<int>(player)][static_cast<int>(PieceType::Pawn)][square];
+    position.psqtScore -= pieceSquareScores[static_cast<int>(player)][static_cast<int>(position.board[square])][square];
+    position.phase -= phaseWeights[static_cast<int>(position.board[square])];
+    position.pieces[static_cast<int>(player)][static_cast<int>(position.board[square])] &= ~squareBit(square);
+    position.occupancy[static_cast<int>(player)] &= ~squareBit(square);
+    position.board[square] = PieceType::Empty;
+}
+
+//This function sets up the pieces in their standard starting squares
+void initPosition(Position& position) {
+    clearPosition(position);
+
+    const PieceType backRank[8] = {
+        PieceType::Rook, PieceType::Knight, PieceType::Bishop, PieceType::Queen,
+        PieceType::King, PieceType::Bishop, PieceType::Knight, PieceType::Rook
+    };
+
+    for (int file = 0; file < 8; ++file) {
+        putPiece(position, Player::White, backRank[file], squareOf(file, 0));
+        putPiece(position, Player::White, PieceType::Pawn, squareOf(file, 1));
+        putPiece(position, Player::Black, PieceType::Pawn, squareOf(file, 6));
+        putPiece(position, Player::Black, backRank[file], squareOf(file, 7));
+    }
+
+    position.sideToMove = Player::White;
+    position.castlingRights = WhiteKingSide | WhiteQueenSide | BlackKingSide | BlackQueenSide;
+    position.key = computeKey(position);
+}
+
+// This function sets up a position from Forsyth-Edwards Notation, the move counters are optional
+void setFromFen(Position& result, const std::string& fen) {
+    // Parsed aside, so the position is left as it was when the FEN is rejected
+    Position position;
+    clearPosition(position);
+
+    std::istringstream stream(fen);
+    std::string placement, side, castling, enPassant;
+    stream >> placement >> side >> castling >> enPassant;
+    if (placement.empty() || side.empty()) {
+        throw std::runtime_error("Invalid FEN: " + fen);
+    }
+
+    const std::string pieceLetters = "pnbrqk";
+    int file = 0;
+    int rank = 7;
+    // Every rank must be exactly 8 squares wide, and there must be exactly 8 of them
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) {
+                throw std::runtime_error("Invalid FEN: " + fen);
+            }
+            file = 0;
+            --rank;
+        }
+        else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) {
+                throw std::runtime_error("Invalid FEN: " + fen);
+            }
+        }
+        else {
+            size_t index = pieceLetters.find(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+            if (index == std::string::npos || file > 7) {
+                throw std::runtime_error("Invalid FEN: " + fen);
+            }
+            if (static_cast<PieceType>(index) == PieceType::Pawn && (rank == 0 || rank == 7)) {
+                throw std::runtime_error("Invalid FEN, pawns can not stand on the first or last rank: " + fen);
+            }
+            putPiece(position, std::isupper(static_cast<unsigned char>(c)) ? Player::White : Player::Black, static_cast<PieceType>(index), squareOf(file, rank));
+            ++file;
+        }
+    }
+    if (file != 8 || rank != 0) {
+        throw std::runtime_error("Invalid FEN: " + fen);
+    }
+    if (std::popcount(piecesOf(position, Player::White, PieceType::King)) != 1 || std::popcount(piecesOf(position, Player::Black, PieceType::King)) != 1) {
+        throw std::runtime_error("Invalid FEN, each side needs exactly one king: " + fen);
+    }
+
+    if (side != "w" && side != "b") {
+        throw std::runtime_error("Invalid FEN, the side to move must be w or b: " + fen);
+    }
+    position.sideToMove = (side == "b") ? Player::Black : Player::White;
+    // The king of the side that just moved can not be left in check, the search would capture it
+    Player waiting = getOppositePlayer(position.sideToMove);
+    if (isSquareAttacked(position, kingSquare(position, waiting), position.sideToMove)) {
+        throw std::runtime_error("Invalid FEN, the side not to move is in check: " + fen);
+    }
+
+    for (char c : castling) {
+        switch (c) {
+        case 'K': position.castlingRights |= WhiteKingSide; break;
+        case 'Q': position.castlingRights |= WhiteQueenSide; break;
+        case 'k': position.castlingRights |= BlackKingSide; break;
+        case 'q': position.castlingRights |= BlackQueenSide; break;
+        default: break;
+        }
+    }
+    // A right is only kept while its king and rook stand on their home squares
+    for (int square : { squareOf(0, 0), squareOf(4, 0), squareOf(7, 0), squareOf(0, 7), squareOf(4, 7), squareOf(7, 7) }) {
+        Player owner = rankOf(square) == 0 ? Player::White : Player::Black;
+        PieceType home = fileOf(square) == 4 ? PieceType::King : PieceType::Rook;
+        if (playerAt(position, square) != owner || pieceAt(position, square) != home) {
+            position.castlingRights &= castlingMask[square];
+        }
+    }
+
+    if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && (enPassant[1] == '3' || enPassant[1] == '6')) {
+        int square = squareOf(enPassant[0] - 'a', enPassant[1] - '1');
+        Player mover = getOppositePlayer(position.sideToMove);
+        if (pawnAttacks(mover, square) & piecesOf(position, position.sideToMove, PieceType::Pawn)) {
+            position.epSquare = square;
+        }
+    }
+
+    if (!(stream >> position.halfmoveClock)) position.halfmoveClock = 0;
+    if (!(stream >> position.fullmoveNumber)) position.fullmoveNumber = 1;
+    position.key = computeKey(position);
+    result = position;
+}
+
+// Writes the position as FEN. The en passant square is only given when a pawn can capture there, as setFromFen() keeps it
+std::string toFen(const Position& position) {
+    const std::string pieceLetters = "pnbrqk";
+    std::string fen;
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+        for (int file = 0; file < 8; ++file) {
+            int square = squareOf(file, rank);
+            Player player = playerAt(position, square);
+            if (player == Player::None) {
+                ++empty;
+                continue;
+            }
+            if (empty) fen += static_cast<char>('0' + empty);
+            empty = 0;
+            char letter = pieceLetters[static_cast<int>(pieceAt(position, square))];
+            fen += player == Player::White ? static_cast<char>(std::toupper(static_cast<unsigned char>(letter))) : letter;
+        }
+        if (empty) fen += static_cast<char>('0' + empty);
+        if (rank > 0) fen += '/';
+    }
+
+    fen += position.sideToMove == Player::White ? " w " : " b ";
+
+    std::string castling;
+    if (position.castlingRights & WhiteKingSide) castling += 'K';
+    if (position.castlingRights & WhiteQueenSide) castling += 'Q';
+    if (position.castlingRights & BlackKingSide) castling += 'k';
+    if (position.castlingRights & BlackQueenSide) castling += 'q';
+    fen += castling.empty() ? "-" : castling;
+
+    fen += ' ';
+    if (position.epSquare != NoSquare) {
+        fen += static_cast<char>('a' + fileOf(position.epSquare));
+        fen += static_cast<char>('1' + rankOf(position.epSquare));
+    }
+    else {
+        fen += '-';
+    }
+
+    fen += " " + std::to_string(position.halfmoveClock) + " " + std::to_string(position.fullmoveNumber);
+    return fen;
+}
+
+// Central function to executing a chess move within the game logic.
+// It moves a piece from its starting square to its destination square, handles captures, castling, en passant and promotions,
+// and returns the information undoMove() needs to restore the position.
+UndoInfo makeMove(Position& position, Move move) {
+    int from = move.from();
+    int to = move.to();
+    Player player = playerAt(position, from);
+    Player enemyPlayer = getOppositePlayer(player);
+    PieceType type = pieceAt(position, from);
+    int capturedSquare = (move.flags() == EnPassant) ? to + (player == Player::White ? -8 : 8) : to;
+
+    UndoInfo undo;
+    undo.capturedType = pieceAt(position, capturedSquare);
+    undo.castlingRights = position.castlingRights;
+    undo.epSquare = static_cast<uint8_t>(position.epSquare);
+    undo.halfmoveClock = static_cast<uint16_t>(position.halfmoveClock);
+    undo.key = position.key;
+
+    if (move.isCapture()) {
+        removePiece(position, capturedSquare);
+    }
+    removePiece(position, from);
+    putPiece(position, player, move.isPromotion() ? move.promotionType() : type, to);
+
+    if (move.isCastle()) {
+        int rookFrom = (move.flags() == KingCastle) ? from + 3 : from - 4;
+        int rookTo = (from + to) / 2;
+        removePiece(position, rookFrom);
+        putPiece(position, player, PieceType::Rook, rookTo);
+    }
+
+    if (position.epSquare != NoSquare) {
+        position.key ^= zobrist.enPassantFile[fileOf(position.epSquare)];
+        position.epSquare = NoSquare;
+    }
+    if (move.flags() == DoublePawnPush && (pawnAttacks(player, (from + to) / 2) & piecesOf(position, enemyPlayer, PieceType::Pawn))) {
+        position.epSquare = (from + to) / 2;
+        position.key ^= zobrist.enPassantFile[fileOf(position.epSquare)];
+    }
+
+    position.halfmoveClock = (type == PieceType::Pawn || move.isCapture()) ? 0 : position.halfmoveClock + 1;
+    if (player == Player::Black) ++position.fullmoveNumber;
+
+    position.key ^= zobrist.castling[position.castlingRights];
+    position.castlingRights &= castlingMask[from] & castlingMask[to];
+    position.key ^= zobrist.castling[position.castlingRights];
+
+    position.sideToMove = enemyPlayer;
+    position.key ^= zobrist.blackToMove;
+    return undo;
+}
+
+// This function reverses the effects of a previously made move, restoring the position to its state before that move was executed.
+// This is essential for AI algorithms
+void undoMove(Position& position, Move move, const UndoInfo& undo) {
+    int from = move.from();
+    int to = move.to();
+    Player player = playerAt(position, to);
+    PieceType type = move.isPromotion() ? PieceType::Pawn : pieceAt(position, to);
+
+    removePiece(position, to);
+    putPiece(position, player, type, from);
+    if (move.isCapture()) {
+        int capturedSquare = (move.flags() == EnPassant) ? to + (player == Player::White ? -8 : 8) : to;
+        putPiece(position, getOppositePlayer(player), undo.capturedType, capturedSquare);
+    }
+
+    if (move.isCastle()) {
+        int rookFrom = (move.flags() == KingCastle) ? from + 3 : from - 4;
+        int rookTo = (from + to) / 2;
+        removePiece(position, rookTo);
+        putPiece(position, player, PieceType::Rook, rookFrom);
+    }
+
+    position.castlingRights = undo.castlingRights;
+    position.epSquare = undo.epSquare;
+    position.halfmoveClock = undo.halfmoveClock;
+    if (player == Player::Black) --position.fullmoveNumber;
+    position.sideToMove = player;
+    position.key = undo.key;
+}
+
+// Passes the turn to the opponent without moving a piece, used by the null move pruning of the search.
+// Only the side to move and the en passant square change
+UndoInfo makeNullMove(Position& position) {
+    UndoInfo undo;
+    undo.epSquare = static_cast<uint8_t>(position.epSquare);
+    undo.halfmoveClock = static_cast<uint16_t>(position.halfmoveClock);
+    undo.key = position.key;
+
+    if (position.epSquare != NoSquare) {
+        position.key ^= zobrist.enPassantFile[fileOf(position.epSquare)];
+        position.epSquare = NoSquare;
+    }
+    ++position.halfmoveClock;
+    position.sideToMove = getOppositePlayer(position.sideToMove);
+    position.key ^= zobrist.blackToMove;
+    return undo;
+}
+
+void undoNullMove(Position& position, const UndoInfo& undo) {
+    position.epSquare = undo.epSquare;
+    position.halfmoveClock = undo.halfmoveClock;
+    position.sideToMove = getOppositePlayer(position.sideToMove);
+    position.key = undo.key;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "move.h"
+#include "score.h"
+#include "types.h"
+#include <array>
+#include <string>
+
+// Attacks of both players in one position, filled on first use by attackInfo() in rules.h.
+// The attacked squares of a player are seen through the enemy king, so the king can not step back along a checking line
+struct AttackInfo {
+    std::array<Bitboard, 2> attacked{};
+    std::array<Bitboard, 2> byPawns{};
+    std::array<Bitboard, 2> byMinors{};
+    std::array<Bitboard, 2> byRooks{};
+    std::array<Bitboard, 2> checkers{}; // Enemy pieces giving check to each player's king
+    std::array<Bitboard, 2> pinned{};   // Pieces of each player that may only move along the line to their king
+};
+
+// Compact board state used by all rules and search code.
+// Pieces are kept both as bitboards (for attack and move generation) and as a mailbox (for O(1) lookups by square).
+// The GUI board is only a view that is synced from this structure.
+struct Position {
+    std::array<std::array<Bitboard, 6>, 2> pieces{};
+    std::array<Bitboard, 2> occupancy{};
+    std::array<PieceType, 64> board{};
+    Player sideToMove = Player::White;
+    uint8_t castlingRights = 0;
+    int epSquare = NoSquare; // Square behind a pawn that just moved two steps, set only if an enemy pawn can capture there
+    int halfmoveClock = 0;
+    int fullmoveNumber = 1;
+    uint64_t key = 0; // Zobrist key, kept up to date by every change to the position
+    uint64_t pawnKey = 0; // Zobrist key of the pawns alone, for the pawn hash table
+    Score psqtScore = 0; // Material and piece-square score of all pieces, positive when White is better
+    int phase = 0; // Sum of phaseWeights over all pieces, falls from 24 towards 0 as pieces are traded
+
+    // Cache of attackInfo(), it belongs to the position with the key it was computed for.
+    // Every move changes the key, so making or undoing a move invalidates it
+    mutable AttackInfo attacks;
+    mutable uint64_t attacksKey = 0;
+    mutable bool hasAttacks = false;
+};
+
+inline Bitboard piecesOf(const Position& position, Player player, PieceType type) {
+    return position.pieces[static_cast<int>(player)][static_cast<int>(type)];
+}
+
+inline Bitboard occupiedSquares(const Position& position) {
+    return position.occupancy[0] | position.occupancy[1];
+}
+
+inline PieceType pieceAt(const Position& position, int square) {
+    return position.board[square];
+}
+
+inline Player playerAt(const Position& position, int square) {
+    if (position.occupancy[0] & squareBit(square)) return Player::White;
+    if (position.occupancy[1] & squareBit(square)) return Player::Black;
+    return Player::None;
+}
+
+inline int kingSquare(const Position& position, Player player) {
+    return std::countr_zero(piecesOf(position, player, PieceType::King));
+}
+
+uint64_t computeKey(const Position& position);
+void clearPosition(Position& position);
+void initPosition(Position& position);
+// Reads a FEN record. EPD records work too, the move counters then default to 0 and 1 and the operations are ignored
+// Throws std::runtime_error on an invalid record or an illegal position and leaves the position unchanged
+void setFromFen(Position& position, const std::string& fen);
+std::string toFen(const Position& position);
+void putPiece(Position& position, Player player, PieceType type, int square);
+void removePiece(Position& position, int square);
+
+UndoInfo makeMove(Position& position, Move move);
+void undoMove(Position& position, Move move, const UndoInfo& undo);
+UndoInfo makeNullMove(Position& position);
+void undoNullMove(Position& position, const UndoInfo& undo);
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "score.h"
+#include "types.h"
+#include <array>
+
+// Middlegame piece-square tables in PieceType order, written from White's point of view with the 8th rank on top
+constexpr int pieceSquareTables[6][8][8] = {
+    // Pawn
+    {{ 150,  150,  150,  150,    0,  150,  150,  150},
+     {  80,   80,   80,   80,   80,   80,   80,   80},
+     { 100,  100,  200,  300,  300,  200,  100,  100},
+     {  50,   50,  100,  250,  250,  100,   50,   50},
+     {   0,    0,    0,  100,  200,    0,    0,    0},
+     {  50,  -50, -100,    0,    0, -100,  -50,   50},
+     {  50,  100,  100, -200, -200,  100,  100,   50},
+     {   0,    0,    0,    0,    0,    0,    0,    0}},
+    // Knight
+    {{-500, -400, -300, -300, -300, -300, -400, -500},
+     {-400, -200,    0,    0,    0,    0, -200, -400},
+     {-300,    0,  100,  150,  150,  100,    0, -300},
+     {-300,   50,  150,  200,  200,  150,   50, -300},
+     {-300,    0,  150,  200,  200,  150,    0, -300},
+     {-300,   50,  100,  150,  150,  100,   50, -300},
+     {-500, -200,    0,   50,   50,    0, -200, -500},
+     {-500, -200, -300, -300, -300, -300, -200, -500}},
+    // Bishop
+    {{-200, -100, -100, -100, -100, -100, -100, -200},
+     {-100,    0,    0,    0,    0,    0,    0, -100},
+     {-100,    0,   50,  100,  100,   50,    0, -100},
+     {-100,   50,   50,  100,  100,   50,   50, -100},
+     {-100,    0,  100,  100,  100,  100,    0, -100},
+     {-100,  100,  100,  100,  100,  100,  100, -100},
+     {-100,   50,    0,    0,    0,    0,   50, -100},
+     {-200, -100, -100, -100, -100, -100, -100, -200}},
+    // Rook
+    {{   0,    0,    0,    0,    0,    0,    0,    0},
+     {  50,  100,  100,  100,  100,  100,  100,   50},
+     { -50,    0,    0,    0,    0,    0,    0,  -50},
+     { -50,    0,    0,    0,    0,    0,    0,  -50},
+     { -50,    0,    0,    0,    0,    0,    0,  -50},
+     { -50,    0,    0,    0,    0,    0,    0,  -50},
+     { -50,    0,    0,    0,    0,    0,    0,  -50},
+     {   0,    0,    0,   50,   50,    0,    0,    0}},
+    // Queen
+    {{-200, -100, -100,  -50,  -50, -100, -100, -200},
+     {-100,    0,    0,    0,    0,    0,    0, -100},
+     {-100,    0,   50,   50,   50,   50,    0, -100},
+     { -50,    0,   50,   50,   50,   50,    0,  -50},
+     {   0,    0,   50,   50,   50,   50,    0,  -50},
+     {-100,   50,   50,   50,   50,   50,    0, -100},
+     {-100,    0,   50,    0,    0,    0,    0, -100},
+     {-200, -100, -100,  -50,  -50, -100, -100, -200}},
+    // King
+    {{-300, -400, -400, -500, -500, -400, -400, -300},
+     {-300, -400, -400, -500, -500, -400, -400, -300},
+     {-300, -400, -400, -500, -500, -400, -400, -300},
+     {-300, -400, -400, -500, -500, -400, -400, -300},
+     {-200, -300, -300, -400, -400, -300, -300, -200},
+     {-100, -200, -200, -200, -200, -200, -200, -100},
+     { 200,  200,    0,    0,    0,    0,  200,  200},
+     { 200,  300,  100,    0,    0,  100,  300,  200}}
+};
+
+// In the endgame pawns are worth more the further they have advanced, wherever they stand on the rank.
+// The bonus stays small, a pawn about to promote must be worth far less than the queen it becomes.
+// Passed pawns get more on top of this in pawns.cpp
+constexpr int endgamePawnTable[8][8] = {
+    {   0,    0,    0,    0,    0,    0,    0,    0},
+    {  60,   60,   60,   60,   60,   60,   60,   60},
+    {  40,   40,   40,   40,   40,   40,   40,   40},
+    {  25,   25,   25,   25,   25,   25,   25,   25},
+    {  15,   15,   15,   15,   15,   15,   15,   15},
+    {   5,    5,    5,    5,    5,    5,    5,    5},
+    {   0,    0,    0,    0,    0,    0,    0,    0},
+    {   0,    0,    0,    0,    0,    0,    0,    0}
+};
+
+// In the endgame the king leaves its shelter and belongs in the centre
+constexpr int endgameKingTable[8][8] = {
+    {-500, -400, -300, -200, -200, -300, -400, -500},
+    {-300, -200, -100,    0,    0, -100, -200, -300},
+    {-300, -100,  200,  300,  300,  200, -100, -300},
+    {-300, -100,  300,  400,  400,  300, -100, -300},
+    {-300, -100,  300,  400,  400,  300, -100, -300},
+    {-300, -100,  200,  300,  300,  200, -100, -300},
+    {-300, -300,    0,    0,    0,    0, -300, -300},
+    {-500, -300, -300, -300, -300, -300, -300, -500}
+};
+
+// Material counted by the evaluation, as middlegame and endgame value.
+// The king is never captured, so it has no material value here
+constexpr std::array<Score, 6> materialScores = {
+    makeScore(100, 120), makeScore(320, 320), makeScore(330, 330), makeScore(500, 500), makeScore(900, 900), makeScore(0, 0)
+};
+
+// Game phase is the sum of these weights over all pieces on the board: 24 with all pieces, 0 with only kings and pawns
+constexpr std::array<int, 6> phaseWeights = { 0, 1, 1, 2, 4, 0 };
+constexpr int totalPhase = 24;
+
+// Black reads the tables rotated by 180 degrees
+constexpr int tableValue(const int (&table)[8][8], Player player, int square) {
+    int row = (player == Player::White) ? 7 - rankOf(square) : rankOf(square);
+    int column = (player == Player::White) ? fileOf(square) : 7 - fileOf(square);
+    return table[row][column];
+}
+
+constexpr int pieceSquareTableValue(PieceType type, Player player, int square) {
+    return tableValue(pieceSquareTables[static_cast<int>(type)], player, square);
+}
+
+// Only pawns and the king change their preferred squares in the endgame, the other pieces keep their middlegame table
+constexpr int endgamePieceSquareTableValue(PieceType type, Player player, int square) {
+    switch (type) {
+    case PieceType::Pawn: return tableValue(endgamePawnTable, player, square);
+    case PieceType::King: return tableValue(endgameKingTable, player, square);
+    default: return pieceSquareTableValue(type, player, square);
+    }
+}
+
+// Material plus piece-square score of every piece on every square, indexed by player, piece and square,
+// positive for White and negative for Black. Position keeps the sum over its pieces up to date in putPiece()/removePiece()
+using PieceSquareScores = std::array<std::array<std::array<Score, 64>, 6>, 2>;
+
+constexpr PieceSquareScores makePieceSquareScores() {
+    PieceSquareScores scores{};
+    for (int type = 0; type < 6; ++type) {
+        for (int square = 0; square < 64; ++square) {
+            for (Player player : { Player::White, Player::Black }) {
+                PieceType pieceType = static_cast<PieceType>(type);
+                Score score = materialScores[type] + makeScore(pieceSquareTableValue(pieceType, player, square),
+                    endgamePieceSquareTableValue(pieceType, player, square));
+                scores[static_cast<int>(player)][type][square] = (player == Player::White) ? score : -score;
+            }
+        }
+    }
+    return scores;
+}
+
+constexpr PieceSquareScores pieceSquareScores = makePieceSquareScores();
@@ -0,0 +1,374 @@
+#include "rules.h"
+#include "attacks.h"
+
+bool isSquareAttacked(const Position& position, int square, Player byPlayer) {
+    Bitboard occupied = occupiedSquares(position);
+    Bitboard queens = piecesOf(position, byPlayer, PieceType::Queen);
+
+    if (knightAttacks(square) & piecesOf(position, byPlayer, PieceType::Knight)) return true;
+    if (kingAttacks(square) & piecesOf(position, byPlayer, PieceType::King)) return true;
+    if (pawnAttacks(getOppositePlayer(byPlayer), square) & piecesOf(position, byPlayer, PieceType::Pawn)) return true;
+    if (bishopAttacks(square, occupied) & (piecesOf(position, byPlayer, PieceType::Bishop) | queens)) return true;
+    if (rookAttacks(square, occupied) & (piecesOf(position, byPlayer, PieceType::Rook) | queens)) return true;
+
+    return false;
+}
+
+bool isKingInCheck(const Position& position, Player currentPlayer) {
+    return attackInfo(position).checkers[static_cast<int>(currentPlayer)] != 0;
+}
+
+bool isPathClear(const Position& position, int from, int to) {
+    return !(betweenSquares(from, to) & occupiedSquares(position));
+}
+
+Bitboard attackersTo(const Position& position, int square, Bitboard occupied) {
+    auto both = [&position](PieceType type) {
+        return piecesOf(position, Player::White, type) | piecesOf(position, Player::Black, type);
+        };
+
+    return (pawnAttacks(Player::Black, square) & piecesOf(position, Player::White, PieceType::Pawn))
+        | (pawnAttacks(Player::White, square) & piecesOf(position, Player::Black, PieceType::Pawn))
+        | (knightAttacks(square) & both(PieceType::Knight))
+        | (kingAttacks(square) & both(PieceType::King))
+        | (bishopAttacks(square, occupied) & (both(PieceType::Bishop) | both(PieceType::Queen)))
+        | (rookAttacks(square, occupied) & (both(PieceType::Rook) | both(PieceType::Queen)));
+}
+
+// Pieces of the player that stand alone between their king and an enemy slider, they may only move along that line
+static Bitboard findPinnedPieces(const Position& position, Player currentPlayer, int king) {
+    Player enemyPlayer = getOppositePlayer(currentPlayer);
+    Bitboard enemies = position.occupancy[static_cast<int>(enemyPlayer)];
+    Bitboard queens = piecesOf(position, enemyPlayer, PieceType::Queen);
+    Bitboard snipers = (bishopAttacks(king, enemies) & (piecesOf(position, enemyPlayer, PieceType::Bishop) | queens))
+        | (rookAttacks(king, enemies) & (piecesOf(position, enemyPlayer, PieceType::Rook) | queens));
+
+    Bitboard occupied = occupiedSquares(position);
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = betweenSquares(king, popLsb(snipers)) & occupied;
+        if (std::popcount(blockers) == 1) {
+            pinned |= blockers & position.occupancy[static_cast<int>(currentPlayer)];
+        }
+    }
+    return pinned;
+}
+
+static void computeAttackInfo(const Position& position, AttackInfo& info) {
+    Bitboard occupied = occupiedSquares(position);
+
+    for (Player player : { Player::White, Player::Black }) {
+        int side = static_cast<int>(player);
+        Player enemyPlayer = getOppositePlayer(player);
+        Bitboard throughKing = occupied ^ piecesOf(position, enemyPlayer, PieceType::King);
+        auto attacksOf = [&position, player, throughKing](PieceType type) {
+            Bitboard pieces = piecesOf(position, player, type);
+            Bitboard attacks = 0;
+            while (pieces) {
+                attacks |= attacksFrom(type, player, popLsb(pieces), throughKing);
+            }
+            return attacks;
+            };
+
+        info.byPawns[side] = attacksOf(PieceType::Pawn);
+        info.byMinors[side] = attacksOf(PieceType::Knight) | attacksOf(PieceType::Bishop);
+        info.byRooks[side] = attacksOf(PieceType::Rook);
+        info.attacked[side] = info.byPawns[side] | info.byMinors[side] | info.byRooks[side]
+            | attacksOf(PieceType::Queen) | attacksOf(PieceType::King);
+
+        info.checkers[side] = 0;
+        info.pinned[side] = 0;
+        if (piecesOf(position, player, PieceType::King)) {
+            int king = kingSquare(position, player);
+            info.checkers[side] = attackersTo(position, king, occupied) & position.occupancy[static_cast<int>(enemyPlayer)];
+            info.pinned[side] = findPinnedPieces(position, player, king);
+        }
+    }
+}
+
+// Check detection, castling, king moves, the evaluation and the GUI hints all ask about the attacks of the same position,
+// often several times. They are computed once per position and then answered from the cache in the position
+const AttackInfo& attackInfo(const Position& position) {
+    if (!position.hasAttacks || position.attacksKey != position.key) {
+        computeAttackInfo(position, position.attacks);
+        position.attacksKey = position.key;
+        position.hasAttacks = true;
+    }
+    return position.attacks;
+}
+
+static Bitboard nonKingPieces(const Position& position, Player currentPlayer) {
+    return position.occupancy[static_cast<int>(currentPlayer)] & ~piecesOf(position, currentPlayer, PieceType::King);
+}
+
+static void addTargets(const Position& position, MoveList& moves, int from, Bitboard targets) {
+    while (targets) {
+        int to = popLsb(targets);
+        moves.add(Move(from, to, pieceAt(position, to) != PieceType::Empty ? Capture : Quiet));
+    }
+}
+
+// A pawn reaching the last rank has to promote, all four promotions are separate moves
+static void addPawnMove(MoveList& moves, int from, int to, bool capture) {
+    int captureFlag = capture ? Capture : Quiet;
+    if (rankOf(to) == 0 || rankOf(to) == 7) {
+        moves.add(Move(from, to, QueenPromotion | captureFlag));
+        moves.add(Move(from, to, RookPromotion | captureFlag));
+        moves.add(Move(from, to, BishopPromotion | captureFlag));
+        moves.add(Move(from, to, KnightPromotion | captureFlag));
+    }
+    else {
+        moves.add(Move(from, to, captureFlag));
+    }
+}
+
+static void addPawnMoves(const Position& position, MoveList& moves, int square, Player currentPlayer, Bitboard allowed) {
+    int forward = (currentPlayer == Player::White) ? 8 : -8;
+    int startRank = (currentPlayer == Player::White) ? 1 : 6;
+    Bitboard occupied = occupiedSquares(position);
+
+    int oneStep = square + forward;
+    if (!(occupied & squareBit(oneStep))) {
+        if (allowed & squareBit(oneStep)) {
+            addPawnMove(moves, square, oneStep, false);
+        }
+        int twoSteps = oneStep + forward;
+        if (rankOf(square) == startRank && !(occupied & squareBit(twoSteps)) && (allowed & squareBit(twoSteps))) {
+            moves.add(Move(square, twoSteps, DoublePawnPush));
+        }
+    }
+
+    Bitboard captures = pawnAttacks(currentPlayer, square) & position.occupancy[static_cast<int>(getOppositePlayer(currentPlayer))] & allowed;
+    while (captures) {
+        addPawnMove(moves, square, popLsb(captures), true);
+    }
+}
+
+// En passant removes two pieces from the capturing pawn's rank, which can expose the king along that rank.
+// Each capture is therefore checked against the occupancy after the move
+static void addEnPassantMoves(const Position& position, MoveList& moves, Player currentPlayer, int king) {
+    if (position.epSquare == NoSquare || position.sideToMove != currentPlayer) return;
+
+    Player enemyPlayer = getOppositePlayer(currentPlayer);
+    int target = position.epSquare;
+    int capturedSquare = target + (currentPlayer == Player::White ? -8 : 8);
+    Bitboard enemies = position.occupancy[static_cast<int>(enemyPlayer)] & ~squareBit(capturedSquare);
+    Bitboard pawns = pawnAttacks(enemyPlayer, target) & piecesOf(position, currentPlayer, PieceType::Pawn);
+
+    while (pawns) {
+        int from = popLsb(pawns);
+        Bitboard occupied = (occupiedSquares(position) ^ squareBit(from) ^ squareBit(capturedSquare)) | squareBit(target);
+        if (!(attackersTo(position, king, occupied) & enemies)) {
+            moves.add(Move(from, target, EnPassant));
+        }
+    }
+}
+
+// Adds the moves of the given pieces (never the king) whose end square lies in targetMask.
+// Pinned pieces are additionally restricted to the line through their king
+static void addPieceMoves(const Position& position, MoveList& moves, Player currentPlayer, Bitboard pieces, Bitboard targetMask, Bitboard pinned, int king) {
+    Bitboard occupied = occupiedSquares(position);
+    targetMask &= ~position.occupancy[static_cast<int>(currentPlayer)];
+
+    while (pieces) {
+        int square = popLsb(pieces);
+        Bitboard allowed = (pinned & squareBit(square)) ? targetMask & lineThrough(king, square) : targetMask;
+
+        switch (pieceAt(position, square)) {
+        case PieceType::Pawn:
+            addPawnMoves(position, moves, square, currentPlayer, allowed);
+            break;
+        case PieceType::Knight:
+            addTargets(position, moves, square, knightAttacks(square) & allowed);
+            break;
+        case PieceType::Bishop:
+            addTargets(position, moves, square, bishopAttacks(square, occupied) & allowed);
+            break;
+        case PieceType::Rook:
+            addTargets(position, moves, square, rookAttacks(square, occupied) & allowed);
+            break;
+        case PieceType::Queen:
+            addTargets(position, moves, square, queenAttacks(square, occupied) & allowed);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// The king may step to any square the enemy does not attack, with the attacks seen through the king itself
+static void addKingMoves(const Position& position, MoveList& moves, int king, Player currentPlayer, Bitboard targetMask) {
+    Player enemyPlayer = getOppositePlayer(currentPlayer);
+    Bitboard enemies = position.occupancy[static_cast<int>(enemyPlayer)];
+    Bitboard targets = kingAttacks(king) & ~position.occupancy[static_cast<int>(currentPlayer)]
+        & ~attackInfo(position).attacked[static_cast<int>(enemyPlayer)] & targetMask;
+
+    while (targets) {
+        int to = popLsb(targets);
+        moves.add(Move(king, to, (enemies & squareBit(to)) ? Capture : Quiet));
+    }
+}
+
+// Castling is allowed while the rights are kept, the squares between king and rook are empty,
+// and the king neither passes through nor lands on an attacked square. The caller makes sure the king is not in check
+static bool canCastle(const Position& position, Player currentPlayer, bool kingSide) {
+    uint8_t right = (currentPlayer == Player::White) ? (kingSide ? WhiteKingSide : WhiteQueenSide)
+                                                     : (kingSide ? BlackKingSide : BlackQueenSide);
+    if (!(position.castlingRights & right)) return false;
+
+    int king = kingSquare(position, currentPlayer);
+    int rook = kingSide ? king + 3 : king - 4;
+    int direction = kingSide ? 1 : -1;
+    Bitboard attacked = attackInfo(position).attacked[static_cast<int>(getOppositePlayer(currentPlayer))];
+
+    if (!isPathClear(position, king, rook)) return false;
+    return !(attacked & (squareBit(king + direction) | squareBit(king + 2 * direction)));
+}
+
+// Pushes to the last rank that are not captures, only as queen promotions, since they change the material balance like a capture
+static void addQueenPromotionPushes(const Position& position, MoveList& moves, Player currentPlayer, Bitboard pinned, int king) {
+    int forward = (currentPlayer == Player::White) ? 8 : -8;
+    int promotionRank = (currentPlayer == Player::White) ? 6 : 1;
+    Bitboard occupied = occupiedSquares(position);
+
+    Bitboard pawns = piecesOf(position, currentPlayer, PieceType::Pawn);
+    while (pawns) {
+        int square = popLsb(pawns);
+        int to = square + forward;
+        if (rankOf(square) != promotionRank || (occupied & squareBit(to))) continue;
+        if ((pinned & squareBit(square)) && !(lineThrough(king, square) & squareBit(to))) continue;
+        moves.add(Move(square, to, QueenPromotion));
+    }
+}
+
+// In check only king moves, captures of the checker and blocks of its line can be legal, and in double check only king moves
+static void generateEvasions(const Position& position, Player currentPlayer, MoveList& moves, int king, Bitboard checkers) {
+    addKingMoves(position, moves, king, currentPlayer, ~Bitboard(0));
+    if (std::popcount(checkers) > 1) return;
+
+    Bitboard checkMask = betweenSquares(king, std::countr_zero(checkers)) | checkers;
+    addPieceMoves(position, moves, currentPlayer, nonKingPieces(position, currentPlayer), checkMask, attackInfo(position).pinned[static_cast<int>(currentPlayer)], king);
+    addEnPassantMoves(position, moves, currentPlayer, king);
+}
+
+// This function looks up a move requested from the GUI among the legal moves of the side to move.
+// Pawns reaching the last rank promote to the given piece. It returns an empty move if there is no such legal move
+Move findLegalMove(const Position& position, int from, int to, PieceType promotion) {
+    MoveList moves;
+    generateAllPossibleMoves(position, position.sideToMove, moves);
+    for (Move move : moves) {
+        if (move.from() == from && move.to() == to && (!move.isPromotion() || move.promotionType() == promotion)) {
+            return move;
+        }
+    }
+    return Move();
+}
+
+// This function generates a list of all legal moves available to a player at a given point.
+// Checkers and pinned pieces come from attackInfo(), so no move has to be played to test its legality
+void generateAllPossibleMoves(const Position& position, Player currentPlayer, MoveList& moves) {
+    int king = kingSquare(position, currentPlayer);
+    const AttackInfo& info = attackInfo(position);
+    Bitboard checkers = info.checkers[static_cast<int>(currentPlayer)];
+
+    if (checkers) {
+        generateEvasions(position, currentPlayer, moves, king, checkers);
+        return;
+    }
+
+    addPieceMoves(position, moves, currentPlayer, nonKingPieces(position, currentPlayer), ~Bitboard(0), info.pinned[static_cast<int>(currentPlayer)], king);
+    addEnPassantMoves(position, moves, currentPlayer, king);
+    addKingMoves(position, moves, king, currentPlayer, ~Bitboard(0));
+
+    if (canCastle(position, currentPlayer, true)) {
+        moves.add(Move(king, king + 2, KingCastle));
+    }
+    if (canCastle(position, currentPlayer, false)) {
+        moves.add(Move(king, king - 2, QueenCastle));
+    }
+}
+
+// This function generates the legal captures and queen promotions of a player, which is all the quiescence search looks at.
+// A player in check gets all evasions instead, since in check standing still is not an option
+void generateAllPossibleCaptures(const Position& position, Player currentPlayer, MoveList& moves) {
+    int king = kingSquare(position, currentPlayer);
+    Bitboard enemies = position.occupancy[static_cast<int>(getOppositePlayer(currentPlayer))];
+    const AttackInfo& info = attackInfo(position);
+    Bitboard checkers = info.checkers[static_cast<int>(currentPlayer)];
+
+    if (checkers) {
+        generateEvasions(position, currentPlayer, moves, king, checkers);
+        return;
+    }
+
+    Bitboard pinned = info.pinned[static_cast<int>(currentPlayer)];
+    addPieceMoves(position, moves, currentPlayer, nonKingPieces(position, currentPlayer), enemies, pinned, king);
+    addQueenPromotionPushes(position, moves, currentPlayer, pinned, king);
+    addEnPassantMoves(position, moves, currentPlayer, king);
+    addKingMoves(position, moves, king, currentPlayer, enemies);
+}
+
+// This function answers whether a player can move at all, stopping at the first legal move it finds.
+// King moves are tried first and then one piece at a time. Castling needs no check of its own,
+// because whenever castling is legal so is the king's step towards the rook
+bool hasAnyLegalMove(const Position& position, Player currentPlayer) {
+    int king = kingSquare(position, currentPlayer);
+    const AttackInfo& info = attackInfo(position);
+    Bitboard checkers = info.checkers[static_cast<int>(currentPlayer)];
+
+    MoveList moves;
+    addKingMoves(position, moves, king, currentPlayer, ~Bitboard(0));
+    if (!moves.empty()) return true;
+    if (std::popcount(checkers) > 1) return false;
+
+    Bitboard targetMask = checkers ? betweenSquares(king, std::countr_zero(checkers)) | checkers : ~Bitboard(0);
+    Bitboard pinned = info.pinned[static_cast<int>(currentPlayer)];
+    Bitboard pieces = nonKingPieces(position, currentPlayer);
+    while (pieces) {
+        addPieceMoves(position, moves, currentPlayer, squareBit(popLsb(pieces)), targetMask, pinned, king);
+        if (!moves.empty()) return true;
+    }
+
+    addEnPassantMoves(position, moves, currentPlayer, king);
+    return !moves.empty();
+}
+
+bool isCheckmate(const Position& position, Player currentPlayer) {
+    return isKingInCheck(position, currentPlayer) && !hasAnyLegalMove(position, currentPlayer);
+}
+
+bool hasInsufficientMaterial(const Position& position) {
+    for (Player player : { Player::White, Player::Black }) {
+        if (piecesOf(position, player, PieceType::Queen) | piecesOf(position, player, PieceType::Rook) | piecesOf(position, player, PieceType::Pawn)) {
+            return false;
+        }
+    }
+
+    int whiteBishops = std::popcount(piecesOf(position, Player::White, PieceType::Bishop));
+    int blackBishops = std::popcount(piecesOf(position, Player::Black, PieceType::Bishop));
+    int whiteKnights = std::popcount(piecesOf(position, Player::White, PieceType::Knight));
+    int blackKnights = std::popcount(piecesOf(position, Player::Black, PieceType::Knight));
+
+    auto isLightSquare = [](Bitboard bishops) {
+        int square = std::countr_zero(bishops);
+        return (fileOf(square) + rankOf(square)) % 2 == 1;
+        };
+
+    if (whiteBishops + blackBishops + whiteKnights + blackKnights == 0) return true;  // King vs King
+    if (whiteBishops + blackBishops == 1 && whiteKnights + blackKnights == 0) return true;  // King and Bishop vs King
+    if (whiteKnights == 1 && blackBishops + whiteBishops + blackKnights == 0) return true;  // King and Knight vs King
+    if (blackKnights == 1 && whiteBishops + blackBishops + whiteKnights == 0) return true;  // King and Knight vs King
+    if (whiteBishops == 1 && blackBishops == 1 &&
+        isLightSquare(piecesOf(position, Player::White, PieceType::Bishop)) != isLightSquare(piecesOf(position, Player::Black, PieceType::Bishop))) return true;  // Bishops on opposite colors
+
+    return false;
+}
+
+bool isDraw(const Position& position, Player currentPlayer) {
+    if (!isKingInCheck(position, currentPlayer)) {
+        if (hasInsufficientMaterial(position) || !hasAnyLegalMove(position, currentPlayer)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "position.h"
+
+bool isSquareAttacked(const Position& position, int square, Player byPlayer);
+bool isKingInCheck(const Position& position, Player currentPlayer);
+bool isPathClear(const Position& position, int from, int to);
+
+Bitboard attackersTo(const Position& position, int square, Bitboard occupied);
+const AttackInfo& attackInfo(const Position& position);
+
+Move findLegalMove(const Position& position, int from, int to, PieceType promotion = PieceType::Queen);
+void generateAllPossibleMoves(const Position& position, Player currentPlayer, MoveList& moves);
+void generateAllPossibleCaptures(const Position& position, Player currentPlayer, MoveList& moves);
+
+bool hasAnyLegalMove(const Position& position, Player currentPlayer);
+
+bool isCheckmate(const Position& position, Player currentPlayer);
+bool hasInsufficientMaterial(const Position& position);
+bool isDraw(const Position& position, Player currentPlayer);
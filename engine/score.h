@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+// A middlegame and an endgame value packed into one integer, so both halves are updated with a single addition.
+// The endgame value sits in the upper 16 bits and the middlegame value in the lower 16 bits,
+// a negative middlegame value borrows one from the upper half, which egValue() gives back
+using Score = int32_t;
+
+constexpr Score makeScore(int mg, int eg) {
+    return static_cast<Score>(static_cast<uint32_t>(eg) << 16) + mg;
+}
+
+constexpr int mgValue(Score score) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score)));
+}
+
+constexpr int egValue(Score score) {
+    return static_cast<int16_t>(static_cast<uint16_t>((static_cast<uint32_t>(score) + 0x8000) >> 16));
+}
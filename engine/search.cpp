@@ -0,0 +1,746 @@
+#include "search.h"
+#include "book.h"
+#include "evaluate.h"
+#include "rules.h"
+#include "notation.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TranspositionTable transpositionTable(16);
+EvalCache evalCache;
+
+static constexpr int maxSearchDepth = 64;
+
+static int searchThreads = 1;
+static ParallelSearch parallelSearch = ParallelSearch::LazySmp;
+
+// Nodes closer to the leaves than this are not split, their subtrees are too small to be worth a task
+static constexpr int minSplitDepth = 3;
+
+// Bound wider than any score, including mates
+static constexpr int infiniteScore = mateScore + 1;
+
+// Scores beyond this are mates, their distance to the root is encoded in the score
+static constexpr int mateBound = mateScore - 1000;
+
+// Workers of the Young Brothers Wait search, kept between searches
+static std::unique_ptr<WorkStealingPool> splitPool;
+
+// Threads of the Lazy SMP helpers, also kept between searches so their pawn tables and heuristics stay filled
+static std::unique_ptr<WorkStealingPool> helperPool;
+
+// State of one search that all of its threads share
+struct SharedSearch {
+    std::chrono::steady_clock::time_point start;
+    int hardLimitMs = 0;
+    uint64_t nodeLimit = 0;
+    bool infinite = false;
+    SearchParameters parameters;
+    const std::atomic<bool>* stopSignal = nullptr;
+    std::atomic<bool> stopThreads{ false };
+    std::atomic<uint64_t> nodes{ 0 };
+    std::atomic<uint64_t> evalProbes{ 0 };
+    std::atomic<uint64_t> evalHits{ 0 };
+    TranspositionTable* table = nullptr;
+    WorkStealingPool* pool = nullptr;
+};
+
+// A node whose remaining moves are searched in parallel after its first move.
+// The bounds are shared, and a cutoff found by one task aborts all of its siblings and everything below them
+struct SplitPoint {
+    SplitPoint* parent = nullptr;
+    SharedSearch* shared = nullptr;
+    std::atomic<int> alpha{ 0 };
+    int beta = 0;
+    std::atomic<bool> cutoff{ false };
+    std::mutex mutex;
+    int bestScore = 0;
+    Move bestMove;
+};
+
+// State of the running search that the recursion needs to decide when to give up.
+// Every search thread has its own, so the threads only meet in SharedSearch and the transposition table
+struct SearchControl {
+    SharedSearch* shared = nullptr;
+    SplitPoint* splitPoint = nullptr;
+    uint64_t nodes = 0;
+    uint64_t evalProbes = 0;
+    uint64_t evalHits = 0;
+    bool stopped = false;
+};
+
+static thread_local SearchControl control;
+
+// Each thread learns on its own heuristics unless findBestMove() was handed a set of the caller's
+static thread_local SearchHeuristics threadHeuristics;
+static thread_local SearchHeuristics* heuristics = &threadHeuristics;
+
+// Best move of one search thread and the last depth it completed
+struct ThreadResult {
+    Move bestMove;
+    int score = 0;
+    int depth = 0;
+};
+
+void setSearchThreads(int count) {
+    searchThreads = std::clamp(count, 1, 256);
+}
+
+int getSearchThreads() {
+    return searchThreads;
+}
+
+void setParallelSearch(ParallelSearch mode) {
+    parallelSearch = mode;
+}
+
+static int elapsedMs() {
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - control.shared->start).count());
+}
+
+static bool stopRequested(const SharedSearch& shared) {
+    return shared.stopThreads.load(std::memory_order_relaxed)
+        || (shared.stopSignal && shared.stopSignal->load(std::memory_order_relaxed));
+}
+
+// True when the result of the current subtree will be thrown away, because the search is stopping
+// or a split point above it has been cut off by a sibling
+static bool searchAborted() {
+    if (control.stopped) {
+        return true;
+    }
+    for (SplitPoint* split = control.splitPoint; split; split = split->parent) {
+        if (split->cutoff.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void flushEvalCounts(SharedSearch& shared) {
+    shared.evalProbes.fetch_add(control.evalProbes, std::memory_order_relaxed);
+    shared.evalHits.fetch_add(control.evalHits, std::memory_order_relaxed);
+    control.evalProbes = 0;
+    control.evalHits = 0;
+}
+
+// The stop flags are checked at every node so a cancelled search ends at once.
+// Reading the clock is slow compared to a node, so it is only checked every 2048 nodes,
+// which is also when the node and eval cache counts of the thread are added to the shared counts.
+// Running out of time or nodes stops all threads of the search
+static bool shouldStop() {
+    if (control.stopped) {
+        return true;
+    }
+    SharedSearch& shared = *control.shared;
+    if (stopRequested(shared)) {
+        control.stopped = true;
+    }
+    else if ((++control.nodes & 2047) == 0) {
+        uint64_t nodes = shared.nodes.fetch_add(2048, std::memory_order_relaxed) + 2048;
+        flushEvalCounts(shared);
+        if ((shared.hardLimitMs > 0 && elapsedMs() >= shared.hardLimitMs) || (shared.nodeLimit > 0 && nodes >= shared.nodeLimit)) {
+            shared.stopThreads.store(true, std::memory_order_relaxed);
+            control.stopped = true;
+        }
+    }
+    return searchAborted();
+}
+
+// Moves the best move remembered in the transposition table to the front, so it is searched first
+static bool putMoveFirst(MoveList& moves, Move first) {
+    for (int i = 0; i < moves.size(); ++i) {
+        if (moves[i] == first) {
+            std::rotate(moves.begin(), moves.begin() + i, moves.begin() + i + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Mate scores count the plies from the root. The table stores them counted from the node instead,
+// so a mate found in one part of the tree keeps its meaning when the position is reached at another ply
+static int scoreToTT(int score, int ply) {
+    if (score >= mateBound) return score + ply;
+    if (score <= -mateBound) return score - ply;
+    return score;
+}
+
+static int scoreFromTT(int score, int ply) {
+    if (score >= mateBound) return score - ply;
+    if (score <= -mateBound) return score + ply;
+    return score;
+}
+
+static Bound boundFor(int score, int alpha, int beta) {
+    if (score <= alpha) return Bound::Upper;
+    if (score >= beta) return Bound::Lower;
+    return Bound::Exact;
+}
+
+static bool isQuiet(Move move) {
+    return !move.isCapture() && !move.isPromotion();
+}
+
+// The evaluation is from White's point of view, negamax needs it from the side to move.
+// Transpositions and the next iteration reach the same positions again, their evaluation comes from the cache
+static int evaluateForSideToMove(const Position& position) {
+    int score = 0;
+    ++control.evalProbes;
+    if (evalCache.probe(position.key, score)) {
+        ++control.evalHits;
+    }
+    else {
+        score = evaluatePosition(position);
+        evalCache.store(position.key, score);
+    }
+    return position.sideToMove == Player::White ? score : -score;
+}
+
+// In pawn endings passing is often the best move (zugzwang), so null moves are only tried with a piece on the board
+static bool hasNonPawnMaterial(const Position& position, Player player) {
+    return piecesOf(position, player, PieceType::Knight) | piecesOf(position, player, PieceType::Bishop)
+        | piecesOf(position, player, PieceType::Rook) | piecesOf(position, player, PieceType::Queen);
+}
+
+// Reduction of a late quiet move by depth left and move number, growing with the logarithm of both
+static const auto lateMoveReductions = [] {
+    std::array<std::array<int, 64>, 64> table{};
+    for (int depth = 1; depth < 64; ++depth) {
+        for (int index = 1; index < 64; ++index) {
+            table[depth][index] = static_cast<int>(0.75 + std::log(depth) * std::log(index) / 2.25);
+        }
+    }
+    return table;
+    }();
+
+// Moves that the ordering ranks high are reduced less, killers and moves with a good history by one ply or more,
+// and moves with a bad history more
+static int lateMoveReduction(const Position& position, Move move, int depth, int index, int ply, bool pvNode) {
+    int reduction = lateMoveReductions[std::min(depth, 63)][std::min(index, 63)];
+    if (pvNode) {
+        --reduction;
+    }
+    if (move == heuristics->killers[ply][0] || move == heuristics->killers[ply][1]) {
+        --reduction;
+    }
+    reduction -= heuristics->history[static_cast<int>(position.sideToMove)][move.from()][move.to()] / 8192;
+    return std::clamp(reduction, 0, depth - 2);
+}
+
+// Only nodes on the principal variation are split, their first move is the one most likely to be best,
+// so once it has been searched the bounds are good enough that the other moves rarely waste work
+static bool canSplit(bool pvNode, int depth) {
+    return control.shared->pool && pvNode && depth >= minSplitDepth;
+}
+
+// Task of one move below a split point. It searches with the bounds known when it starts, first with a null window
+// like every move after the first, and tightens alpha for the tasks that start after it
+static void searchSplitMove(SplitPoint& split, Position& position, Move move, int depth, int ply) {
+    SearchControl ownerControl = control;
+    control.shared = split.shared;
+    control.splitPoint = &split;
+    control.stopped = false;
+
+    if (!searchAborted()) {
+        int alpha = split.alpha.load(std::memory_order_relaxed);
+        int beta = split.beta;
+        makeMove(position, move);
+        int score = -negamax(position, depth - 1, -alpha - 1, -alpha, ply + 1, move);
+        if (score > alpha && score < beta && !searchAborted()) {
+            score = -negamax(position, depth - 1, -beta, -alpha, ply + 1, move, true);
+        }
+
+        if (!searchAborted()) {
+            std::lock_guard<std::mutex> lock(split.mutex);
+            if (score > split.bestScore) {
+                split.bestScore = score;
+                split.bestMove = move;
+            }
+            split.alpha.store(std::max(split.alpha.load(std::memory_order_relaxed), score), std::memory_order_relaxed);
+            if (split.alpha.load(std::memory_order_relaxed) >= split.beta) {
+                split.cutoff.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    SearchControl taskControl = control;
+    control = ownerControl;
+    control.nodes = taskControl.nodes;
+    control.evalProbes = taskControl.evalProbes;
+    control.evalHits = taskControl.evalHits;
+}
+
+// Young Brothers Wait: the moves from index first on become tasks of the work stealing pool,
+// and the calling thread runs tasks until all of them are done. Afterwards alpha and the best move
+// of the node include every task that finished
+static void searchSplit(Position& position, const MoveList& moves, int first, int depth, int ply,
+    int& alpha, int beta, int& bestScore, Move& bestMove) {
+    SplitPoint split;
+    split.parent = control.splitPoint;
+    split.shared = control.shared;
+    split.alpha.store(alpha);
+    split.beta = beta;
+    split.bestScore = bestScore;
+    split.bestMove = bestMove;
+
+    WorkStealingPool& pool = *control.shared->pool;
+    TaskGroup group;
+    for (int i = first; i < moves.size(); ++i) {
+        pool.submit(group, [&split, move = moves[i], depth, ply, taskPosition = position]() mutable {
+            searchSplitMove(split, taskPosition, move, depth, ply);
+            });
+    }
+    pool.wait(group);
+
+    // A task that ran out of time stopped the whole search, the node is incomplete then
+    if (stopRequested(*control.shared)) {
+        control.stopped = true;
+    }
+    alpha = split.alpha.load();
+    bestScore = split.bestScore;
+    bestMove = split.bestMove;
+}
+
+// Material the side to move gains with a capture or promotion, before any recapture
+static int captureGain(Move move, const Position& position) {
+    int gain = move.flags() == EnPassant ? getPieceValue(PieceType::Pawn) : getPieceValue(pieceAt(position, move.to()));
+    if (move.isPromotion()) {
+        gain += getPieceValue(move.promotionType()) - getPieceValue(PieceType::Pawn);
+    }
+    return gain;
+}
+
+// This function continues the search at the leaves until no captures are left, so a leaf is never scored in the middle
+// of an exchange. The side to move may stand pat on the static evaluation instead of capturing, except in check,
+// where every evasion is searched and no evasion is checkmate like in negamax()
+static int quiescence(Position& position, int alpha, int beta, int ply) {
+    if (shouldStop()) {
+        return 0;
+    }
+
+    bool inCheck = isKingInCheck(position, position.sideToMove);
+    int standPat = 0;
+    int bestScore = -infiniteScore;
+
+    if (!inCheck) {
+        standPat = evaluateForSideToMove(position);
+        if (standPat >= beta) return standPat;
+        alpha = std::max(alpha, standPat);
+        bestScore = standPat;
+    }
+
+    MoveList moves;
+    generateAllPossibleCaptures(position, position.sideToMove, moves);
+    if (inCheck && moves.empty()) {
+        return -(mateScore - ply);
+    }
+    MoveScores scores;
+    scoreMoves(moves, position, scores);
+
+    for (int i = 0; i < moves.size(); ++i) {
+        Move move = pickMove(moves, scores, i);
+        // Delta pruning, and captures that lose material in the exchange on the target square are skipped
+        if (!inCheck) {
+            if (standPat + captureGain(move, position) + control.shared->parameters.deltaMargin <= alpha) {
+                continue;
+            }
+            if (isLosingCapture(move, position)) {
+                continue;
+            }
+        }
+
+        UndoInfo undo = makeMove(position, move);
+        int score = -quiescence(position, -beta, -alpha, ply + 1);
+        undoMove(position, move, undo);
+
+        if (score > bestScore) {
+            bestScore = score;
+            alpha = std::max(alpha, score);
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return bestScore;
+}
+
+// Principal variation search in negamax form: scores are from the point of view of the side to move.
+// The first move is searched with the full window, every later move only has to be proven worse with a null window
+// around alpha and is searched again with the full window when that fails.
+// Nodes off the principal variation are pruned before the move loop when the static evaluation is far above beta
+// or a null move still fails high. Quiet moves late in the ordering are searched shallower, and near the leaves
+// they are skipped when even a large margin would not lift the evaluation to alpha
+int negamax(Position& position, int depth, int alpha, int beta, int ply, Move previousMove, bool pvNode) {
+    // The result of an abandoned search is thrown away, so any score will do
+    if (shouldStop()) {
+        return 0;
+    }
+
+    bool inCheck = isKingInCheck(position, position.sideToMove);
+    // A check is answered one ply deeper, so it is never left to the quiescence search alone
+    if (inCheck) {
+        ++depth;
+    }
+    if (depth <= 0) {
+        return quiescence(position, alpha, beta, ply);
+    }
+    if (ply >= maxPly) {
+        return evaluateForSideToMove(position);
+    }
+
+    if (position.halfmoveClock >= 100 || hasInsufficientMaterial(position)) {
+        return 0;
+    }
+
+    TTData ttData;
+    if (control.shared->table->probe(position.key, ttData) && ttData.depth >= depth && !pvNode) {
+        int ttScore = scoreFromTT(ttData.score, ply);
+        if (ttData.bound == Bound::Exact) return ttScore;
+        if (ttData.bound == Bound::Lower && ttScore >= beta) return ttScore;
+        if (ttData.bound == Bound::Upper && ttScore <= alpha) return ttScore;
+    }
+
+    int staticEval = inCheck ? -infiniteScore : evaluateForSideToMove(position);
+
+    const SearchParameters& parameters = control.shared->parameters;
+    if (!pvNode && !inCheck && std::abs(beta) < mateBound) {
+        if (depth <= parameters.reverseFutilityDepth && staticEval - parameters.reverseFutilityMargin * depth >= beta) {
+            return staticEval;
+        }
+
+        // Passing is never allowed twice in a row, the null move is the previous move then
+        if (parameters.nullMoveMinDepth > 0 && depth >= parameters.nullMoveMinDepth && staticEval >= beta && !previousMove.isNone()
+            && hasNonPawnMaterial(position, position.sideToMove)) {
+            int reduction = parameters.nullMoveReduction + depth / 6;
+            UndoInfo undo = makeNullMove(position);
+            int score = -negamax(position, depth - 1 - reduction, -beta, -beta + 1, ply + 1, Move());
+            undoNullMove(position, undo);
+            if (searchAborted()) {
+                return 0;
+            }
+            if (score >= beta) {
+                return score >= mateBound ? beta : score;
+            }
+        }
+    }
+
+    MoveList moves;
+    generateAllPossibleMoves(position, position.sideToMove, moves);
+
+    // Without a legal move the game is over: checkmate, where a quicker mate scores higher, or stalemate
+    if (moves.empty()) {
+        return inCheck ? -(mateScore - ply) : 0;
+    }
+
+    MoveScores scores;
+    scoreMoves(moves, position, *heuristics, ttData.move, previousMove, ply, scores);
+    MoveList quietsTried;
+
+    bool futile = !pvNode && !inCheck && depth <= parameters.futilityDepth && staticEval + parameters.futilityMargin * depth <= alpha;
+    int originalAlpha = alpha;
+    int bestScore = -infiniteScore;
+    Move bestMove;
+
+    for (int i = 0; i < moves.size(); ++i) {
+        if (i == 1 && canSplit(pvNode, depth)) {
+            sortMoves(moves, scores, 1);
+            searchSplit(position, moves, 1, depth, ply, alpha, beta, bestScore, bestMove);
+            break;
+        }
+        Move move = pickMove(moves, scores, i);
+        bool quiet = isQuiet(move);
+        int reduction = 0;
+        if (quiet && !inCheck && parameters.lateMoveMinDepth > 0 && i >= parameters.lateMoveMinIndex && depth >= parameters.lateMoveMinDepth) {
+            reduction = lateMoveReduction(position, move, depth, i, ply, pvNode);
+        }
+
+        UndoInfo undo = makeMove(position, move);
+        bool givesCheck = isKingInCheck(position, position.sideToMove);
+        if (givesCheck) {
+            reduction = 0;
+        }
+        if (futile && quiet && !givesCheck && i > 0) {
+            undoMove(position, move, undo);
+            continue;
+        }
+
+        int score = 0;
+        if (i == 0) {
+            score = -negamax(position, depth - 1, -beta, -alpha, ply + 1, move, pvNode);
+        }
+        else {
+            score = -negamax(position, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, move);
+            if (score > alpha && reduction > 0) {
+                score = -negamax(position, depth - 1, -alpha - 1, -alpha, ply + 1, move);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(position, depth - 1, -beta, -alpha, ply + 1, move, true);
+            }
+        }
+        undoMove(position, move, undo);
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            alpha = std::max(alpha, score);
+        }
+        if (alpha >= beta) {
+            if (quiet && !searchAborted()) {
+                heuristics->updateQuiet(position, move, previousMove, ply, depth, quietsTried);
+            }
+            break;
+        }
+        if (quiet) {
+            quietsTried.add(move);
+        }
+    }
+    if (searchAborted()) {
+        return 0;
+    }
+
+    control.shared->table->store(position.key, depth, scoreToTT(bestScore, ply), boundFor(bestScore, originalAlpha, beta), bestMove);
+    return bestScore;
+}
+
+// Searches all root moves to the given depth within the window, the best move of the previous iteration first,
+// and returns the best score found. A score at or below alpha only bounds the true score and keeps the previous best move.
+// Only moves whose search finished count, so an iteration abandoned halfway can still improve on the previous one
+static int searchRoot(Position& position, int depth, int alpha, int beta, MoveList& rootMoves, Move& bestMove, int& bestScore) {
+    putMoveFirst(rootMoves, bestMove);
+
+    int originalAlpha = alpha;
+    int iterationScore = -infiniteScore;
+    Move iterationBest;
+
+    for (int i = 0; i < rootMoves.size(); ++i) {
+        if (i == 1 && control.shared->pool) {
+            // Only a move that beat the first one replaces it, a task score at or below alpha is just a bound
+            int splitAlpha = alpha;
+            int splitScore = iterationScore;
+            Move splitBest;
+            searchSplit(position, rootMoves, 1, depth, 0, alpha, beta, splitScore, splitBest);
+            if (splitScore > splitAlpha && !splitBest.isNone()) {
+                iterationBest = splitBest;
+            }
+            iterationScore = std::max(iterationScore, splitScore);
+            break;
+        }
+        Move move = rootMoves[i];
+        UndoInfo undo = makeMove(position, move);
+        int score = 0;
+        if (i == 0) {
+            score = -negamax(position, depth - 1, -beta, -alpha, 1, move, true);
+        }
+        else {
+            score = -negamax(position, depth - 1, -alpha - 1, -alpha, 1, move);
+            if (score > alpha && score < beta && !control.stopped) {
+                score = -negamax(position, depth - 1, -beta, -alpha, 1, move, true);
+            }
+        }
+        undoMove(position, move, undo);
+
+        if (control.stopped) {
+            break;
+        }
+        iterationScore = std::max(iterationScore, score);
+        if (score > alpha) {
+            iterationBest = move;
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    if (!iterationBest.isNone()) {
+        bestMove = iterationBest;
+        bestScore = iterationScore;
+    }
+    if (!control.stopped && iterationScore > originalAlpha && iterationScore < beta) {
+        control.shared->table->store(position.key, depth, scoreToTT(iterationScore, 0), Bound::Exact, bestMove);
+    }
+    return iterationScore;
+}
+
+// Iterative deepening of one search thread. Only the main thread (index 0) watches the soft time limit and reports progress.
+// Helper threads search the same root and mostly help by filling the transposition table.
+// Every other helper starts one ply deeper, so the threads are rarely all on the same depth at the same time
+static ThreadResult iterativeDeepening(Position& position, SharedSearch& shared, MoveList rootMoves, int maxDepth, int threadIndex,
+    const TimeBudget& budget, const ProgressCallback& onProgress) {
+    control = SearchControl{};
+    control.shared = &shared;
+    heuristics->newSearch();
+
+    ThreadResult result;
+    result.bestMove = rootMoves[0];
+    for (int depth = 1 + threadIndex % 2; depth <= maxDepth; ++depth) {
+        // Aspiration window: the score rarely moves far from the previous iteration, so the root is searched with a narrow
+        // window around it first. A score outside the window is searched again with the window widened on that side
+        int delta = shared.parameters.aspirationDelta;
+        int alpha = -infiniteScore;
+        int beta = infiniteScore;
+        if (shared.parameters.aspirationMinDepth > 0 && depth >= shared.parameters.aspirationMinDepth) {
+            alpha = std::max(result.score - delta, -infiniteScore);
+            beta = std::min(result.score + delta, infiniteScore);
+        }
+        while (true) {
+            int score = searchRoot(position, depth, alpha, beta, rootMoves, result.bestMove, result.score);
+            if (control.stopped) {
+                break;
+            }
+            if (score <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -infiniteScore);
+            }
+            else if (score >= beta) {
+                beta = std::min(score + delta, infiniteScore);
+            }
+            else {
+                break;
+            }
+            delta *= 2;
+        }
+        if (control.stopped) {
+            break;
+        }
+        result.depth = depth;
+
+        if (threadIndex > 0) {
+            continue;
+        }
+        if (onProgress) {
+            uint64_t nodes = shared.nodes.load(std::memory_order_relaxed) + (control.nodes & 2047);
+            uint64_t evalProbes = shared.evalProbes.load(std::memory_order_relaxed) + control.evalProbes;
+            uint64_t evalHits = shared.evalHits.load(std::memory_order_relaxed) + control.evalHits;
+            onProgress(SearchProgress{ depth, result.score, nodes, elapsedMs(), result.bestMove, evalProbes, evalHits });
+        }
+
+        // With a single legal move or after the soft limit there is nothing to gain from another iteration,
+        // unless the search was asked to go on until it is stopped
+        if (!shared.infinite && (rootMoves.size() == 1 || (budget.softLimitMs > 0 && elapsedMs() >= budget.softLimitMs))) {
+            break;
+        }
+    }
+
+    shared.nodes.fetch_add(control.nodes & 2047, std::memory_order_relaxed);
+    flushEvalCounts(shared);
+    return result;
+}
+
+// An infinite search holds its result until the caller stops it, also when it ran out of depth or moves early
+static void waitForStop(const SharedSearch& shared) {
+    while (shared.infinite && !shared.stopSignal->load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+//This function searches one ply deeper at a time until the time budget or the depth limit runs out.
+//With Lazy SMP the helper threads are stopped as soon as the main thread is done,
+//and the move of the thread that completed the deepest iteration is played.
+//With Young Brothers Wait only the calling thread runs iterative deepening and the pool workers take its split moves
+Move findBestMove(Position& position, const SearchLimits& limits, TranspositionTable& table, const std::atomic<bool>* stopSignal,
+    const ProgressCallback& onProgress, SearchHeuristics* searchHeuristics, const SearchParameters* parameters) {
+    TimeBudget budget = allocateTime(limits);
+    SharedSearch shared;
+    shared.start = std::chrono::steady_clock::now();
+    shared.hardLimitMs = budget.hardLimitMs;
+    shared.nodeLimit = limits.nodes;
+    shared.infinite = limits.infinite && stopSignal;
+    if (parameters) shared.parameters = *parameters;
+    shared.stopSignal = stopSignal;
+    shared.table = &table;
+
+    table.newSearch();
+
+    MoveList rootMoves;
+    generateAllPossibleMoves(position, position.sideToMove, rootMoves);
+    if (rootMoves.empty()) {
+        waitForStop(shared);
+        return Move();
+    }
+    orderMoves(rootMoves, position);
+
+    TTData ttData;
+    if (table.probe(position.key, ttData)) {
+        putMoveFirst(rootMoves, ttData.move);
+    }
+
+    int maxDepth = limits.depth > 0 ? std::min(limits.depth, maxSearchDepth) : maxSearchDepth;
+
+    int helperCount = searchThreads - 1;
+    if (parallelSearch == ParallelSearch::Ybwc && helperCount > 0) {
+        if (!splitPool || splitPool->size() != helperCount) {
+            splitPool = std::make_unique<WorkStealingPool>(helperCount);
+        }
+        shared.pool = splitPool.get();
+        helperCount = 0;
+    }
+
+    if (helperCount > 0 && (!helperPool || helperPool->size() != helperCount)) {
+        helperPool = std::make_unique<WorkStealingPool>(helperCount);
+    }
+    std::vector<ThreadResult> helperResults(helperCount);
+    TaskGroup helpers;
+    for (int i = 1; i <= helperCount; ++i) {
+        helperPool->submit(helpers, [&, i, helperPosition = position]() mutable {
+            helperResults[i - 1] = iterativeDeepening(helperPosition, shared, rootMoves, maxDepth, i, budget, {});
+            });
+    }
+
+    SearchHeuristics* ownHeuristics = heuristics;
+    if (searchHeuristics) heuristics = searchHeuristics;
+    ThreadResult result = iterativeDeepening(position, shared, rootMoves, maxDepth, 0, budget, onProgress);
+    heuristics = ownHeuristics;
+    waitForStop(shared);
+
+    shared.stopThreads.store(true, std::memory_order_relaxed);
+    if (helperCount > 0) {
+        helperPool->wait(helpers);
+    }
+    for (const ThreadResult& helperResult : helperResults) {
+        if (helperResult.depth > result.depth) {
+            result = helperResult;
+        }
+    }
+    return result.bestMove;
+}
+
+Move findBestMove(Position& position, const SearchLimits& limits, const std::atomic<bool>* stopSignal, const ProgressCallback& onProgress) {
+    return findBestMove(position, limits, transpositionTable, stopSignal, onProgress);
+}
+
+// Prints the search progress to the console
+void printProgress(const SearchProgress& progress) {
+    std::cout << "Depth " << progress.depth << " score " << progress.score << " nodes " << progress.nodes
+        << " time " << progress.timeMs << " ms best " << moveToString(progress.bestMove)
+        << " eval cache hits " << (progress.evalProbes ? progress.evalHits * 100 / progress.evalProbes : 0) << "%" << '\n';
+}
+
+//This function is responsible for determining and executing the AI's best possible move.
+//A move from the opening book is played without searching
+Move aiMakeMove(Position& position, const SearchLimits& limits) {
+    Move bestMove = openingBook.probe(position);
+    if (!bestMove.isNone()) {
+        std::cout << "AI plays a book move" << '\n';
+        makeMove(position, bestMove);
+        return bestMove;
+    }
+
+    std::cout << "AI is thinking" << '\n';
+    bestMove = findBestMove(position, limits, nullptr, printProgress);
+    if (!bestMove.isNone()) {
+        makeMove(position, bestMove);
+    }
+    return bestMove;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "eval_cache.h"
+#include "ordering.h"
+#include "position.h"
+#include "timeman.h"
+#include "tt.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// Score of a checkmate for the side that mates. A mate found n plies from the root scores mateScore - n,
+// so a quicker mate scores higher
+constexpr int mateScore = 100000;
+
+// Shared by all searches and kept between moves, its size in MB can be changed with resize()
+extern TranspositionTable transpositionTable;
+
+// Static evaluations of all searches, looked up before a position is evaluated
+extern EvalCache evalCache;
+
+// Reported after every finished iteration of the search, the score is from the point of view of the side to move
+struct SearchProgress {
+    int depth = 0;
+    int score = 0;
+    uint64_t nodes = 0;
+    int timeMs = 0;
+    Move bestMove;
+    uint64_t evalProbes = 0; // Lookups in evalCache so far
+    uint64_t evalHits = 0;
+};
+
+using ProgressCallback = std::function<void(const SearchProgress&)>;
+
+// Pruning and reduction settings of the search. The defaults are the engine's own, other sets let a match compare
+// variants of the search. A minimum depth of 0 switches null moves, late move reductions or aspiration windows off,
+// a maximum depth of 0 switches reverse futility or futility pruning off
+struct SearchParameters {
+    int aspirationDelta = 25;        // half width of the first aspiration window at the root
+    int aspirationMinDepth = 5;      // first iteration that uses one
+    int reverseFutilityDepth = 6;    // a node this close to the leaves whose static evaluation beats beta by the margin
+    int reverseFutilityMargin = 80;  // per ply left is cut off without a search
+    int futilityDepth = 3;           // quiet moves are skipped this close to the leaves when the static evaluation
+    int futilityMargin = 150;        // plus the margin per ply left can not reach alpha
+    int nullMoveMinDepth = 3;        // depth left that null move pruning needs
+    int nullMoveReduction = 3;       // the null move is searched at least this many plies shallower
+    int lateMoveMinIndex = 3;        // late move reductions start with this move of a node
+    int lateMoveMinDepth = 3;        // that has at least this much depth left
+    int deltaMargin = 200;           // quiescence skips captures that can not reach alpha even when winning this much more
+};
+
+// How findBestMove() uses more than one thread. Lazy SMP lets every thread search the whole tree and share
+// the transposition table, Young Brothers Wait splits the moves of a node into tasks of a work stealing pool
+enum class ParallelSearch { LazySmp, Ybwc };
+
+// Number of threads used by findBestMove(), 1 by default
+void setSearchThreads(int count);
+int getSearchThreads();
+void setParallelSearch(ParallelSearch mode);
+
+// Scores the position from the point of view of the side to move, searching depth plies ahead.
+// ply is the distance from the root and previousMove the move that led here, an empty move after a null move
+int negamax(Position& position, int depth, int alpha, int beta, int ply = 0, Move previousMove = Move(), bool pvNode = false);
+// Searches the side to move without changing the position. The search ends early once stopSignal is set,
+// and the best move found until then is returned
+Move findBestMove(Position& position, const SearchLimits& limits, const std::atomic<bool>* stopSignal = nullptr,
+    const ProgressCallback& onProgress = {});
+// The same search on a table of its own instead of the shared one, so several independent searches can run at once.
+// Given heuristics are used by the calling thread instead of its own, so that two engines on one thread don't share killers and history,
+// and given parameters replace the default ones
+Move findBestMove(Position& position, const SearchLimits& limits, TranspositionTable& table, const std::atomic<bool>* stopSignal = nullptr,
+    const ProgressCallback& onProgress = {}, SearchHeuristics* heuristics = nullptr, const SearchParameters* parameters = nullptr);
+void printProgress(const SearchProgress& progress);
+Move aiMakeMove(Position& position, const SearchLimits& limits);
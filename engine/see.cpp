@@ -0,0 +1,72 @@
+#include "see.h"
+#include "attacks.h"
+#include "evaluate.h"
+#include "rules.h"
+#include <algorithm>
+
+// Least valuable of the player's attackers, its square is returned in from
+static PieceType leastValuableAttacker(const Position& position, Bitboard attackers, Player player, int& from) {
+    for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::King); ++type) {
+        Bitboard pieces = attackers & piecesOf(position, player, static_cast<PieceType>(type));
+        if (pieces) {
+            from = std::countr_zero(pieces);
+            return static_cast<PieceType>(type);
+        }
+    }
+    return PieceType::Empty;
+}
+
+// The exchange is played out on bitboards only. Every capture removes the capturing piece from the occupancy,
+// so sliders lined up behind it (x-rays) join the attackers. The gains are then folded back from the last capture
+// to the first, where each side picks the better of capturing and standing still
+int staticExchange(const Position& position, Move move) {
+    int to = move.to();
+    int from = move.from();
+    Player side = playerAt(position, from);
+    PieceType onSquare = pieceAt(position, from);
+
+    int gain[32];
+    gain[0] = move.flags() == EnPassant ? getPieceValue(PieceType::Pawn) : getPieceValue(pieceAt(position, to));
+    if (move.isPromotion()) {
+        gain[0] += getPieceValue(move.promotionType()) - getPieceValue(PieceType::Pawn);
+        onSquare = move.promotionType();
+    }
+
+    Bitboard occupied = occupiedSquares(position) ^ squareBit(from);
+    if (move.flags() == EnPassant) {
+        occupied ^= squareBit(side == Player::White ? to - 8 : to + 8);
+    }
+    Bitboard diagonalSliders = piecesOf(position, Player::White, PieceType::Bishop) | piecesOf(position, Player::Black, PieceType::Bishop)
+        | piecesOf(position, Player::White, PieceType::Queen) | piecesOf(position, Player::Black, PieceType::Queen);
+    Bitboard straightSliders = piecesOf(position, Player::White, PieceType::Rook) | piecesOf(position, Player::Black, PieceType::Rook)
+        | piecesOf(position, Player::White, PieceType::Queen) | piecesOf(position, Player::Black, PieceType::Queen);
+    Bitboard attackers = attackersTo(position, to, occupied) & occupied;
+
+    int depth = 0;
+    side = getOppositePlayer(side);
+    while (depth < 31) {
+        PieceType attacker = leastValuableAttacker(position, attackers & position.occupancy[static_cast<int>(side)], side, from);
+        if (attacker == PieceType::Empty) {
+            break;
+        }
+        // The king may only take last, when nothing defends the square any more
+        if (attacker == PieceType::King && (attackers & position.occupancy[static_cast<int>(getOppositePlayer(side))])) {
+            break;
+        }
+
+        ++depth;
+        gain[depth] = getPieceValue(onSquare) - gain[depth - 1];
+
+        occupied ^= squareBit(from);
+        attackers |= (bishopAttacks(to, occupied) & diagonalSliders) | (rookAttacks(to, occupied) & straightSliders);
+        attackers &= occupied;
+        onSquare = attacker;
+        side = getOppositePlayer(side);
+    }
+
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        --depth;
+    }
+    return gain[0];
+}
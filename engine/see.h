@@ -0,0 +1,8 @@
+#pragma once
+
+#include "position.h"
+
+// Static exchange evaluation: the material the side to move wins or loses when it plays the move and both sides
+// then keep recapturing on the target square with their least valuable piece, each free to stop when that pays off.
+// Pins and checks are not taken into account
+int staticExchange(const Position& position, Move move);
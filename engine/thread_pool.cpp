@@ -0,0 +1,97 @@
+#include "thread_pool.h"
+
+// Lets a thread find its own queue, threads that are not workers of the pool use the shared last queue
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local int currentQueue = -1;
+
+WorkStealingPool::WorkStealingPool(int threadCount) {
+    for (int i = 0; i <= threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quit.store(true);
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int WorkStealingPool::queueOfCurrentThread() const {
+    return currentPool == this ? currentQueue : static_cast<int>(queues.size()) - 1;
+}
+
+void WorkStealingPool::submit(TaskGroup& group, std::function<void()> task) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    Queue& queue = *queues[queueOfCurrentThread()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(Task{ std::move(task), &group });
+    }
+    queuedTasks.fetch_add(1, std::memory_order_release);
+
+    // Taking the sleep mutex orders this against a worker that has just found nothing to do and is about to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+void WorkStealingPool::wait(TaskGroup& group) {
+    int ownQueue = queueOfCurrentThread();
+    while (!group.done()) {
+        if (!runOneTask(ownQueue)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Takes the newest task of the own queue, or else the oldest task of the first other queue that has one
+bool WorkStealingPool::runOneTask(int ownQueue) {
+    Task task;
+    bool found = false;
+    int queueCount = static_cast<int>(queues.size());
+    for (int i = 0; i < queueCount && !found; ++i) {
+        Queue& queue = *queues[(ownQueue + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        found = true;
+    }
+    if (!found) {
+        return false;
+    }
+
+    queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    task.run();
+    task.group->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void WorkStealingPool::workerLoop(int index) {
+    currentPool = this;
+    currentQueue = index;
+    while (!quit.load()) {
+        if (runOneTask(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return quit.load() || queuedTasks.load(std::memory_order_acquire) > 0; });
+    }
+}
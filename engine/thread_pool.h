@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tasks submitted together and waited for together
+class TaskGroup {
+public:
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class WorkStealingPool;
+    std::atomic<int> pending{ 0 };
+};
+
+// Thread pool in which every worker has its own task queue. A worker runs its newest task first and,
+// once its queue is empty, steals the oldest task of another queue, which in a search is the largest subtree.
+// A thread waiting for a group runs queued tasks meanwhile, so waiting inside a task cannot deadlock the pool
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threadCount);
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    ~WorkStealingPool();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    void submit(TaskGroup& group, std::function<void()> task);
+    void wait(TaskGroup& group);
+
+private:
+    struct Task {
+        std::function<void()> run;
+        TaskGroup* group = nullptr;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // One queue per worker and a last one for threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queuedTasks{ 0 };
+    std::atomic<bool> quit{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    int queueOfCurrentThread() const;
+    bool runOneTask(int ownQueue);
+    void workerLoop(int index);
+};
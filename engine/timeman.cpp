@@ -0,0 +1,29 @@
+#include "timeman.h"
+#include <algorithm>
+
+// Kept back from the clock for move transfer and GUI latency
+static constexpr int moveOverheadMs = 50;
+
+// Without movesToGo the rest of the game is assumed to take this many moves
+static constexpr int defaultMovesToGo = 30;
+
+// A fixed move time is spent completely, but a new iteration is only started while there is a fair chance
+// to finish it, as every iteration takes a few times longer than the one before.
+// With a clock the share of one move is its part of the remaining time plus most of the increment,
+// and the hard limit lets a difficult iteration run up to four times over that share
+TimeBudget allocateTime(const SearchLimits& limits) {
+    if (limits.moveTimeMs > 0) {
+        return { std::max(1, limits.moveTimeMs / 2), limits.moveTimeMs };
+    }
+
+    if (limits.timeLeftMs > 0) {
+        int available = std::max(1, limits.timeLeftMs - moveOverheadMs);
+        int movesToGo = limits.movesToGo > 0 ? limits.movesToGo : defaultMovesToGo;
+
+        int share = std::max(1, available / movesToGo + limits.incrementMs * 3 / 4);
+        int hardLimit = std::min(available, share * 4);
+        return { std::min(share, hardLimit), hardLimit };
+    }
+
+    return {};
+}
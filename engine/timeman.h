@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+// What the caller allows one search to spend. All zero means search until depth is reached
+struct SearchLimits {
+    int depth = 0;        // 0 = no depth limit
+    int moveTimeMs = 0;   // fixed time for this move
+    int timeLeftMs = 0;   // remaining clock time of the side to move
+    int incrementMs = 0;  // time added to the clock after every move
+    int movesToGo = 0;    // moves until the next time control, 0 = rest of the game
+    uint64_t nodes = 0;   // 0 = no node limit, checked every 2048 nodes per thread
+    bool infinite = false; // search until the stop signal, even after the result is settled
+};
+
+// After softLimitMs no new iteration is started, at hardLimitMs the running iteration is abandoned.
+// A limit of 0 means no limit
+struct TimeBudget {
+    int softLimitMs = 0;
+    int hardLimitMs = 0;
+};
+
+TimeBudget allocateTime(const SearchLimits& limits);
@@ -0,0 +1,124 @@
+#include "tt.h"
+#include <algorithm>
+#include <bit>
+
+static uint64_t packData(Move move, int score, int depth, Bound bound, uint8_t generation) {
+    return uint64_t(move.data)
+        | (uint64_t(static_cast<uint32_t>(score)) << 16)
+        | (uint64_t(static_cast<uint8_t>(depth)) << 48)
+        | (uint64_t(bound) << 56)
+        | (uint64_t(generation & 63) << 58);
+}
+
+static Move dataMove(uint64_t data) {
+    Move move;
+    move.data = static_cast<uint16_t>(data);
+    return move;
+}
+
+static int dataScore(uint64_t data) {
+    return static_cast<int32_t>(static_cast<uint32_t>(data >> 16));
+}
+
+static int dataDepth(uint64_t data) {
+    return static_cast<int8_t>(static_cast<uint8_t>(data >> 48));
+}
+
+static Bound dataBound(uint64_t data) {
+    return static_cast<Bound>((data >> 56) & 3);
+}
+
+static uint8_t dataGeneration(uint64_t data) {
+    return static_cast<uint8_t>(data >> 58);
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+// The number of buckets is rounded down to a power of two, so a key can be mapped to a bucket with a mask
+void TranspositionTable::resize(size_t megabytes) {
+    bucketCount = std::bit_floor(std::max<size_t>(1, megabytes * 1024 * 1024 / sizeof(Bucket)));
+    buckets = std::make_unique<Bucket[]>(bucketCount);
+    generation = 0;
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.checkedKey.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 63;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& data) const {
+    for (const Entry& entry : bucketFor(key).entries) {
+        uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+        uint64_t entryKey = entry.checkedKey.load(std::memory_order_relaxed) ^ entryData;
+        if (entryKey == key && dataBound(entryData) != Bound::None) {
+            data.move = dataMove(entryData);
+            data.score = dataScore(entryData);
+            data.depth = dataDepth(entryData);
+            data.bound = dataBound(entryData);
+            return true;
+        }
+    }
+    return false;
+}
+
+// An entry for the same position is overwritten, otherwise the entry with the least depth left is replaced,
+// where entries from earlier searches count as eight plies shallower per search
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, Move move) {
+    Bucket& bucket = bucketFor(key);
+    Entry* replace = nullptr;
+    uint64_t replaceData = 0;
+    bool sameKey = false;
+
+    auto worth = [this](uint64_t entryData) {
+        return dataDepth(entryData) - 8 * ((generation - dataGeneration(entryData)) & 63);
+        };
+
+    for (Entry& entry : bucket.entries) {
+        uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+        uint64_t entryKey = entry.checkedKey.load(std::memory_order_relaxed) ^ entryData;
+        if (entryKey == key || dataBound(entryData) == Bound::None) {
+            replace = &entry;
+            replaceData = entryData;
+            sameKey = entryKey == key;
+            break;
+        }
+        if (!replace || worth(entryData) < worth(replaceData)) {
+            replace = &entry;
+            replaceData = entryData;
+        }
+    }
+
+    // Keep the best move of an earlier search of this position if this one did not find any
+    if (move.isNone() && sameKey) {
+        move = dataMove(replaceData);
+    }
+
+    uint64_t data = packData(move, score, depth, bound, generation);
+    replace->checkedKey.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    size_t sample = std::min<size_t>(bucketCount, 250);
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+            if (dataBound(entryData) != Bound::None && dataGeneration(entryData) == generation) {
+                ++used;
+            }
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * 4));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "move.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+enum class Bound : uint8_t { None, Exact, Lower, Upper };
+
+struct TTData {
+    Move move;
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::None;
+};
+
+// Fixed-size hash table of search results, indexed by the Zobrist key of the position.
+// Entries are grouped in buckets of four that share one 64 byte cache line.
+// All search threads use the table without locks: an entry stores its key XORed with its data,
+// so an entry torn by two threads writing at once does not verify and is treated as a miss
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    void resize(size_t megabytes);
+    void clear();
+
+    // Called once per search before the threads start, older entries are replaced first
+    void newSearch();
+
+    bool probe(uint64_t key, TTData& data) const;
+    void store(uint64_t key, int depth, int score, Bound bound, Move move);
+
+    // Per mille of the entries used by the current search, as reported by UCI engines
+    int hashfull() const;
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> checkedKey; // key ^ data
+        std::atomic<uint64_t> data;       // move:16 | score:32 | depth:8 | bound:2 | generation:6
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[4];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint8_t generation = 0;
+
+    Bucket& bucketFor(uint64_t key) { return buckets[key & (bucketCount - 1)]; }
+    const Bucket& bucketFor(uint64_t key) const { return buckets[key & (bucketCount - 1)]; }
+};
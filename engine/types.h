@@ -0,0 +1,46 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+enum class PieceType : uint8_t { Pawn, Knight, Bishop, Rook, Queen, King, Empty };
+enum class Player : uint8_t { White, Black, None };
+
+// One bit per square. Squares are numbered from a1 = 0 to h8 = 63, rank by rank
+using Bitboard = uint64_t;
+
+constexpr int NoSquare = 64;
+
+enum CastlingRight : uint8_t {
+    WhiteKingSide = 1,
+    WhiteQueenSide = 2,
+    BlackKingSide = 4,
+    BlackQueenSide = 8
+};
+
+constexpr int squareOf(int file, int rank) {
+    return rank * 8 + file;
+}
+
+constexpr int fileOf(int square) {
+    return square & 7;
+}
+
+constexpr int rankOf(int square) {
+    return square >> 3;
+}
+
+constexpr Bitboard squareBit(int square) {
+    return Bitboard(1) << square;
+}
+
+// Removes the lowest set square from the bitboard and returns it
+inline int popLsb(Bitboard& bitboard) {
+    int square = std::countr_zero(bitboard);
+    bitboard &= bitboard - 1;
+    return square;
+}
+
+constexpr Player getOppositePlayer(Player currentPlayer) {
+    return (currentPlayer == Player::White) ? Player::Black : Player::White;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+
+// Random keys XORed together to identify a position. They are generated at compile time from a fixed seed,
+// so the same position has the same key in every build and every run
+struct ZobristKeys {
+    std::array<std::array<std::array<uint64_t, 64>, 6>, 2> pieces{};
+    std::array<uint64_t, 16> castling{};
+    std::array<uint64_t, 8> enPassantFile{};
+    uint64_t blackToMove = 0;
+};
+
+// SplitMix64 step
+constexpr uint64_t nextZobristKey(uint64_t& state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys;
+    uint64_t state = 20240501;
+    for (auto& player : keys.pieces) {
+        for (auto& piece : player) {
+            for (auto& key : piece) {
+                key = nextZobristKey(state);
+            }
+        }
+    }
+    for (auto& key : keys.castling) key = nextZobristKey(state);
+    for (auto& key : keys.enPassantFile) key = nextZobristKey(state);
+    keys.blackToMove = nextZobristKey(state);
+    return keys;
+}
+
+constexpr ZobristKeys zobrist = makeZobristKeys();
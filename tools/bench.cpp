@@ -0,0 +1,121 @@
+// Headless search benchmark.
+// Searches a fixed set of positions to a fixed depth with 1, 2, 4 and 8 threads and reports the time-to-depth speedup
+// of Lazy SMP and of the Young Brothers Wait search.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/attacks.h"
+#include "engine/position.h"
+#include "engine/search.h"
+
+const std::vector<std::string> benchPositions = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+};
+
+// Total time in seconds to search all bench positions to the given depth, every position starts with empty tables
+double timeToDepth(int depth, int threads, uint64_t& nodes, double& evalHitRate) {
+    setSearchThreads(threads);
+    SearchLimits limits;
+    limits.depth = depth;
+
+    double seconds = 0;
+    nodes = 0;
+    uint64_t evalProbes = 0, evalHits = 0;
+    for (const std::string& fen : benchPositions) {
+        Position position;
+        setFromFen(position, fen);
+        transpositionTable.clear();
+        evalCache.clear();
+
+        SearchProgress last;
+        auto start = std::chrono::steady_clock::now();
+        findBestMove(position, limits, nullptr, [&last](const SearchProgress& progress) {
+            last = progress;
+            });
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        nodes += last.nodes;
+        evalProbes += last.evalProbes;
+        evalHits += last.evalHits;
+    }
+    evalHitRate = evalProbes ? 100.0 * evalHits / evalProbes : 0;
+    return seconds;
+}
+
+void printUsage() {
+    std::cout << "Usage: chessvsAI_bench [options]\n"
+        << "  --depth <n>         depth to search every position to (default: 10)\n"
+        << "  --threads <list>    comma separated thread counts (default: 1,2,4,8)\n"
+        << "  --hash <mb>         transposition table size (default: 16)\n"
+        << "  --mode <mode>       smp, ybwc or both (default: both)\n";
+}
+
+int main(int argc, char* argv[]) {
+    int depth = 10;
+    std::vector<int> threadCounts = { 1, 2, 4, 8 };
+    int hashMb = 16;
+    std::string mode = "both";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--depth" && i + 1 < argc) depth = std::atoi(argv[++i]);
+        else if (argument == "--hash" && i + 1 < argc) hashMb = std::atoi(argv[++i]);
+        else if (argument == "--mode" && i + 1 < argc) mode = argv[++i];
+        else if (argument == "--threads" && i + 1 < argc) {
+            threadCounts.clear();
+            std::stringstream list(argv[++i]);
+            std::string count;
+            while (std::getline(list, count, ',')) {
+                threadCounts.push_back(std::atoi(count.c_str()));
+            }
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    initAttacks();
+    transpositionTable.resize(hashMb);
+
+    std::cout << "Depth " << depth << ", " << benchPositions.size() << " positions, hardware threads: "
+        << std::thread::hardware_concurrency() << '\n';
+
+    std::vector<std::pair<std::string, ParallelSearch>> modes;
+    if (mode == "smp" || mode == "both") modes.push_back({ "Lazy SMP", ParallelSearch::LazySmp });
+    if (mode == "ybwc" || mode == "both") modes.push_back({ "YBWC", ParallelSearch::Ybwc });
+
+    for (const auto& [name, parallelSearch] : modes) {
+        std::cout << name << '\n';
+        setParallelSearch(parallelSearch);
+
+        double baseSeconds = 0;
+        for (int threads : threadCounts) {
+            uint64_t nodes = 0;
+            double evalHitRate = 0;
+            double seconds = timeToDepth(depth, threads, nodes, evalHitRate);
+            if (baseSeconds == 0) {
+                baseSeconds = seconds;
+            }
+            std::cout << "Threads: " << threads
+                << "  Time: " << static_cast<int64_t>(seconds * 1000) << " ms"
+                << "  Nodes: " << nodes
+                << "  NPS: " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0)
+                << "  Speedup: " << (seconds > 0 ? baseSeconds / seconds : 0)
+                << "  Eval cache hits: " << evalHitRate << "%" << '\n';
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+// Headless tactical test-suite runner.
+// Reads an EPD file line by line and searches every position that has a bm (best move) or am (avoid move) operation,
+// several positions at once. Reports which positions were solved, how long it took to settle on the solution and the nodes per second.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/attacks.h"
+#include "engine/notation.h"
+#include "engine/position.h"
+#include "engine/search.h"
+#include "engine/thread_pool.h"
+
+struct EpdRecord {
+    std::string fen;
+    std::string id;
+    std::vector<Move> bestMoves;
+    std::vector<Move> avoidMoves;
+};
+
+struct EpdResult {
+    bool solved = false;
+    int timeToSolutionMs = 0;
+    int timeMs = 0;
+    uint64_t nodes = 0;
+};
+
+// Splits an EPD line into the position and its operations, e.g. "<fen fields> bm Qg6; id \"WAC.003\";"
+EpdRecord parseEpd(const std::string& line) {
+    EpdRecord record;
+    std::istringstream stream(line);
+    std::string placement, side, castling, enPassant;
+    stream >> placement >> side >> castling >> enPassant;
+    record.fen = placement + " " + side + " " + castling + " " + enPassant;
+
+    // Some files give a full FEN with move counters before the operations
+    std::string rest;
+    std::getline(stream, rest);
+    std::istringstream counters(rest);
+    int halfmove = 0, fullmove = 0;
+    if (counters >> halfmove >> fullmove) {
+        record.fen += " " + std::to_string(halfmove) + " " + std::to_string(fullmove);
+        std::getline(counters, rest);
+    }
+
+    Position position;
+    setFromFen(position, record.fen);
+
+    std::stringstream operations(rest);
+    std::string operation;
+    while (std::getline(operations, operation, ';')) {
+        std::istringstream fields(operation);
+        std::string opcode, operand;
+        fields >> opcode;
+        while (fields >> operand) {
+            if (opcode == "id") {
+                record.id += (record.id.empty() ? "" : " ") + operand;
+            }
+            else if (opcode == "bm" || opcode == "am") {
+                Move move = parseSan(position, operand);
+                if (move.isNone()) {
+                    throw std::runtime_error("Illegal " + opcode + " move " + operand);
+                }
+                (opcode == "bm" ? record.bestMoves : record.avoidMoves).push_back(move);
+            }
+        }
+    }
+    record.id.erase(std::remove(record.id.begin(), record.id.end(), '"'), record.id.end());
+    return record;
+}
+
+bool solves(const EpdRecord& record, Move move) {
+    if (move.isNone()) return false;
+    if (!record.bestMoves.empty() && std::find(record.bestMoves.begin(), record.bestMoves.end(), move) == record.bestMoves.end()) return false;
+    return std::find(record.avoidMoves.begin(), record.avoidMoves.end(), move) == record.avoidMoves.end();
+}
+
+// The time to solution is the end of the first iteration from which on the search kept a solving move
+EpdResult searchRecord(const EpdRecord& record, const SearchLimits& limits, int hashMb) {
+    Position position;
+    setFromFen(position, record.fen);
+    TranspositionTable table(hashMb);
+
+    EpdResult result;
+    int solvedSinceMs = -1;
+    auto start = std::chrono::steady_clock::now();
+    Move bestMove = findBestMove(position, limits, table, nullptr, [&](const SearchProgress& progress) {
+        if (!solves(record, progress.bestMove)) solvedSinceMs = -1;
+        else if (solvedSinceMs < 0) solvedSinceMs = progress.timeMs;
+        result.nodes = progress.nodes;
+        });
+    result.timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+    result.solved = solves(record, bestMove);
+    if (result.solved) {
+        result.timeToSolutionMs = solvedSinceMs >= 0 ? solvedSinceMs : result.timeMs;
+    }
+    return result;
+}
+
+std::string movesToSan(const EpdRecord& record, const std::vector<Move>& moves) {
+    Position position;
+    setFromFen(position, record.fen);
+    std::string text;
+    for (Move move : moves) {
+        text += (text.empty() ? "" : " ") + moveToSan(position, move);
+    }
+    return text;
+}
+
+void printUsage() {
+    std::cout << "Usage: chessvsAI_epd <file.epd> [options]\n"
+        << "  --movetime <ms>      time per position (default: 1000)\n"
+        << "  --depth <n>          depth per position instead of a time\n"
+        << "  --nodes <n>          nodes per position instead of a time\n"
+        << "  --concurrency <n>    positions searched at once (default: hardware threads)\n"
+        << "  --hash <mb>          table size of every search (default: 16)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    SearchLimits limits;
+    limits.moveTimeMs = 1000;
+    int concurrency = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int hashMb = 16;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--movetime" && i + 1 < argc) limits.moveTimeMs = std::atoi(argv[++i]);
+        else if (argument == "--depth" && i + 1 < argc) {
+            limits.depth = std::atoi(argv[++i]);
+            limits.moveTimeMs = 0;
+        }
+        else if (argument == "--nodes" && i + 1 < argc) {
+            limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+            limits.moveTimeMs = 0;
+        }
+        else if (argument == "--concurrency" && i + 1 < argc) concurrency = std::max(1, std::atoi(argv[++i]));
+        else if (argument == "--hash" && i + 1 < argc) hashMb = std::max(1, std::atoi(argv[++i]));
+        else if (path.empty() && argument[0] != '-') path = argument;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Unable to open " << path << '\n';
+        return 1;
+    }
+
+    initAttacks();
+    // Every position is searched on one thread, the positions themselves are spread over the cores
+    setSearchThreads(1);
+
+    // A deque keeps its elements in place while lines are added, so running tasks can hold on to their record and result
+    std::deque<EpdRecord> records;
+    std::deque<EpdResult> results;
+    std::mutex outputMutex;
+    WorkStealingPool pool(concurrency - 1);
+    TaskGroup group;
+    auto start = std::chrono::steady_clock::now();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') continue;
+        try {
+            EpdRecord record = parseEpd(line);
+            if (record.bestMoves.empty() && record.avoidMoves.empty()) continue;
+            if (record.id.empty()) record.id = "line " + std::to_string(lineNumber);
+            records.push_back(record);
+        }
+        catch (const std::exception& error) {
+            std::cerr << path << ":" << lineNumber << ": " << error.what() << '\n';
+            continue;
+        }
+        results.emplace_back();
+
+        pool.submit(group, [&, &record = records.back(), &result = results.back()]() {
+            result = searchRecord(record, limits, hashMb);
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << (result.solved ? "solved  " : "failed  ") << record.id;
+            if (!record.bestMoves.empty()) std::cout << "  bm " << movesToSan(record, record.bestMoves);
+            if (!record.avoidMoves.empty()) std::cout << "  am " << movesToSan(record, record.avoidMoves);
+            if (result.solved) std::cout << "  in " << result.timeToSolutionMs << " ms";
+            std::cout << '\n';
+            });
+    }
+    pool.wait(group);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int solved = 0;
+    int64_t solutionMs = 0;
+    int64_t searchMs = 0;
+    uint64_t nodes = 0;
+    for (const EpdResult& result : results) {
+        if (result.solved) {
+            ++solved;
+            solutionMs += result.timeToSolutionMs;
+        }
+        searchMs += result.timeMs;
+        nodes += result.nodes;
+    }
+
+    int total = static_cast<int>(results.size());
+    std::cout << "Solved " << solved << " of " << total << " (" << (total ? 100.0 * solved / total : 0.0) << "%)\n"
+        << "Average time to solution: " << (solved ? solutionMs / solved : 0) << " ms\n"
+        << "Nodes: " << nodes << "  nps per search: " << (searchMs > 0 ? nodes * 1000 / searchMs : nodes)
+        << "  aggregate nps: " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : nodes)
+        << "  (" << concurrency << " at once, " << seconds << " s)\n";
+    return 0;
+}
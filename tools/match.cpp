@@ -0,0 +1,450 @@
+// Headless self-play match runner.
+// Plays engine A against engine B from a set of openings, every opening once with each colour, several games at once.
+// Both sides run the engine of this build. They differ by their search limits, search parameters and table size,
+// so a change to the search can be measured by giving it to one side only.
+// The result is reported from A's point of view as an Elo difference with a 95% error margin,
+// optionally with a sequential probability ratio test (SPRT) that ends the match once it accepts either hypothesis.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/attacks.h"
+#include "engine/notation.h"
+#include "engine/position.h"
+#include "engine/rules.h"
+#include "engine/search.h"
+#include "engine/thread_pool.h"
+
+const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Short, common opening lines used when no opening file is given
+const std::vector<std::string> builtInOpenings = {
+    "e2e4 e7e5 g1f3 b8c6 f1b5",
+    "e2e4 e7e5 g1f3 b8c6 f1c4",
+    "e2e4 c7c5 g1f3 d7d6 d2d4",
+    "e2e4 c7c5 b1c3 b8c6 g2g3",
+    "e2e4 e7e6 d2d4 d7d5 b1c3",
+    "e2e4 c7c6 d2d4 d7d5 e4e5",
+    "e2e4 d7d6 d2d4 g8f6 b1c3",
+    "e2e4 d7d5 e4d5 d8d5 b1c3",
+    "d2d4 d7d5 c2c4 e7e6 b1c3",
+    "d2d4 d7d5 c2c4 c7c6 g1f3",
+    "d2d4 g8f6 c2c4 g7g6 b1c3",
+    "d2d4 g8f6 c2c4 e7e6 g1f3",
+    "d2d4 f7f5 g2g3 g8f6 f1g2",
+    "c2c4 e7e5 b1c3 g8f6 g2g3",
+    "g1f3 d7d5 g2g3 g8f6 f1g2",
+    "c2c4 c7c5 g1f3 b8c6 b1c3"
+};
+
+struct Opening {
+    std::string fen;
+    std::vector<std::string> moves;
+};
+
+struct EngineConfig {
+    std::string name;
+    SearchLimits limits;
+    int hashMb = 8;
+    SearchParameters parameters;
+};
+
+struct GameResult {
+    int scoreA = 0; // 2 for a win of engine A, 1 for a draw, 0 for a loss
+    std::string pgn;
+};
+
+// Longer games are adjudicated as draws
+const int maxGamePlies = 600;
+
+// An opening line is either a FEN or EPD record, or a list of moves from the start position
+Opening parseOpening(const std::string& line) {
+    Opening opening;
+    std::istringstream fields(line);
+    std::string first;
+    fields >> first;
+    if (first.find('/') != std::string::npos) {
+        opening.fen = line;
+        return opening;
+    }
+
+    opening.fen = startFen;
+    fields.clear();
+    fields.seekg(0);
+    std::string move;
+    while (fields >> move) {
+        opening.moves.push_back(move);
+    }
+    return opening;
+}
+
+std::vector<Opening> loadOpenings(const std::string& path) {
+    std::vector<Opening> openings;
+    if (path.empty()) {
+        for (const std::string& line : builtInOpenings) {
+            openings.push_back(parseOpening(line));
+        }
+        return openings;
+    }
+
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] != '#') {
+            openings.push_back(parseOpening(line));
+        }
+    }
+    return openings;
+}
+
+std::string todayForPgn() {
+    std::time_t now = std::time(nullptr);
+    char date[16];
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+    return date;
+}
+
+// Plays one game. Checkmate and stalemate or dead positions come from isCheckmate() and isDraw(),
+// the fifty-move rule, threefold repetition and the ply limit are judged here
+GameResult playGame(const Opening& opening, const EngineConfig& white, const EngineConfig& black, bool aIsWhite, int round) {
+    Position position;
+    setFromFen(position, opening.fen);
+    std::string startingFen = toFen(position);
+
+    std::ostringstream moveText;
+    std::vector<uint64_t> keys{ position.key };
+    auto addMove = [&](Move move) {
+        if (position.sideToMove == Player::White) moveText << position.fullmoveNumber << ". ";
+        else if (moveText.tellp() == 0) moveText << position.fullmoveNumber << "... ";
+        moveText << moveToSan(position, move) << ' ';
+        makeMove(position, move);
+        if (position.halfmoveClock == 0) keys.clear();
+        keys.push_back(position.key);
+        };
+
+    for (const std::string& text : opening.moves) {
+        Move move = parseMove(position, text);
+        if (move.isNone()) {
+            throw std::runtime_error("Illegal opening move " + text);
+        }
+        addMove(move);
+    }
+
+    // Each side searches with its own table and move ordering heuristics, nothing one engine learns helps the other
+    TranspositionTable whiteTable(white.hashMb);
+    TranspositionTable blackTable(black.hashMb);
+    SearchHeuristics whiteHeuristics;
+    SearchHeuristics blackHeuristics;
+
+    std::string result;
+    std::string termination;
+    for (int ply = 0; result.empty(); ++ply) {
+        Player side = position.sideToMove;
+        if (isCheckmate(position, side)) {
+            result = side == Player::White ? "0-1" : "1-0";
+            termination = "checkmate";
+        }
+        else if (isDraw(position, side)) {
+            result = "1/2-1/2";
+            termination = hasInsufficientMaterial(position) ? "insufficient material" : "stalemate";
+        }
+        else if (position.halfmoveClock >= 100) {
+            result = "1/2-1/2";
+            termination = "fifty-move rule";
+        }
+        else if (std::count(keys.begin(), keys.end(), position.key) >= 3) {
+            result = "1/2-1/2";
+            termination = "threefold repetition";
+        }
+        else if (ply >= maxGamePlies) {
+            result = "1/2-1/2";
+            termination = "adjudication";
+        }
+        else {
+            const EngineConfig& engine = side == Player::White ? white : black;
+            bool whiteToMove = side == Player::White;
+            Move move = findBestMove(position, engine.limits, whiteToMove ? whiteTable : blackTable, nullptr, {},
+                whiteToMove ? &whiteHeuristics : &blackHeuristics, &engine.parameters);
+            addMove(move);
+        }
+    }
+
+    GameResult game;
+    int whiteScore = result == "1-0" ? 2 : result == "0-1" ? 0 : 1;
+    game.scoreA = aIsWhite ? whiteScore : 2 - whiteScore;
+
+    std::ostringstream pgn;
+    pgn << "[Event \"chessvsAI match\"]\n"
+        << "[Site \"local\"]\n"
+        << "[Date \"" << todayForPgn() << "\"]\n"
+        << "[Round \"" << round << "\"]\n"
+        << "[White \"" << white.name << "\"]\n"
+        << "[Black \"" << black.name << "\"]\n"
+        << "[Result \"" << result << "\"]\n";
+    if (startingFen != startFen) {
+        pgn << "[SetUp \"1\"]\n" << "[FEN \"" << startingFen << "\"]\n";
+    }
+    pgn << "[Termination \"" << termination << "\"]\n\n"
+        << moveText.str() << result << "\n\n";
+    game.pgn = pgn.str();
+    return game;
+}
+
+// Running totals from engine A's point of view
+struct MatchStats {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    double score() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+
+    // Variance of the result of one game
+    double variance() const {
+        double s = score();
+        return games() ? (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games() : 0;
+    }
+};
+
+double eloFromScore(double score) {
+    score = std::clamp(score, 1e-6, 1 - 1e-6);
+    return 400 * std::log10(score / (1 - score));
+}
+
+double scoreFromElo(double elo) {
+    return 1 / (1 + std::pow(10, -elo / 400));
+}
+
+// Log-likelihood ratio of elo1 against elo0, in the normal approximation of the game results
+double sprtLlr(const MatchStats& stats, double elo0, double elo1) {
+    double variance = stats.variance();
+    if (stats.games() == 0 || variance <= 0) {
+        return 0;
+    }
+    double s0 = scoreFromElo(elo0);
+    double s1 = scoreFromElo(elo1);
+    return stats.games() * (s1 - s0) * (2 * stats.score() - s0 - s1) / (2 * variance);
+}
+
+void printStats(const MatchStats& stats) {
+    double elo = eloFromScore(stats.score());
+    double margin = 1.96 * std::sqrt(stats.variance() / std::max(1, stats.games()));
+    double errorElo = (eloFromScore(std::min(0.999999, stats.score() + margin)) - eloFromScore(std::max(0.000001, stats.score() - margin))) / 2;
+
+    std::cout << "Games: " << stats.games() << "  W: " << stats.wins << "  D: " << stats.draws << "  L: " << stats.losses
+        << "  Score: " << stats.score() * 100 << "%  Elo: " << elo << " +/- " << errorElo << '\n';
+}
+
+// Parses limits like "nodes=20000", "movetime=100" or "depth=6,nodes=50000"
+SearchLimits parseLimits(const std::string& text) {
+    SearchLimits limits;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("Invalid limit " + item);
+        }
+        std::string name = item.substr(0, equals);
+        int64_t value = std::atoll(item.c_str() + equals + 1);
+        if (name == "nodes") limits.nodes = static_cast<uint64_t>(value);
+        else if (name == "movetime") limits.moveTimeMs = static_cast<int>(value);
+        else if (name == "depth") limits.depth = static_cast<int>(value);
+        else throw std::runtime_error("Unknown limit " + name);
+    }
+    return limits;
+}
+
+// Parses search parameters like "nullMoveMinDepth=0" or "futilityMargin=120,lateMoveMinIndex=4", the names are those of SearchParameters
+SearchParameters parseParameters(const std::string& text) {
+    const std::pair<const char*, int SearchParameters::*> names[] = {
+        { "aspirationDelta", &SearchParameters::aspirationDelta },
+        { "aspirationMinDepth", &SearchParameters::aspirationMinDepth },
+        { "reverseFutilityDepth", &SearchParameters::reverseFutilityDepth },
+        { "reverseFutilityMargin", &SearchParameters::reverseFutilityMargin },
+        { "futilityDepth", &SearchParameters::futilityDepth },
+        { "futilityMargin", &SearchParameters::futilityMargin },
+        { "nullMoveMinDepth", &SearchParameters::nullMoveMinDepth },
+        { "nullMoveReduction", &SearchParameters::nullMoveReduction },
+        { "lateMoveMinIndex", &SearchParameters::lateMoveMinIndex },
+        { "lateMoveMinDepth", &SearchParameters::lateMoveMinDepth },
+        { "deltaMargin", &SearchParameters::deltaMargin }
+    };
+
+    SearchParameters parameters;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("Invalid parameter " + item);
+        }
+        std::string name = item.substr(0, equals);
+        auto found = std::find_if(std::begin(names), std::end(names), [&name](const auto& entry) { return name == entry.first; });
+        if (found == std::end(names)) {
+            throw std::runtime_error("Unknown parameter " + name);
+        }
+        parameters.*(found->second) = std::atoi(item.c_str() + equals + 1);
+    }
+    return parameters;
+}
+
+void printUsage() {
+    std::cout << "Usage: chessvsAI_match [options]\n"
+        << "  --games <n>            games to play, rounded up to pairs of colours (default: 100)\n"
+        << "  --concurrency <n>      games played at once (default: hardware threads)\n"
+        << "  --openings <file>      FEN, EPD or move list per line (default: built-in openings)\n"
+        << "  --a <limits>           limits of engine A, e.g. nodes=20000 or movetime=100 (default: nodes=20000)\n"
+        << "  --b <limits>           limits of engine B (default: same as A)\n"
+        << "  --a-params <params>    search parameters of engine A, e.g. nullMoveMinDepth=0 or futilityMargin=120 (default: built-in)\n"
+        << "  --b-params <params>    search parameters of engine B (default: built-in)\n"
+        << "  --hash <mb>            table size of each engine in every game (default: 8)\n"
+        << "  --pgn <file>           write the games to this file\n"
+        << "  --sprt <elo0> <elo1>   stop once the SPRT accepts either hypothesis, alpha = beta = 0.05\n";
+}
+
+int main(int argc, char* argv[]) {
+    int games = 100;
+    int concurrency = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string openingsPath, pgnPath;
+    EngineConfig engineA{ "chessvsAI A", parseLimits("nodes=20000") };
+    EngineConfig engineB{ "chessvsAI B", {} };
+    bool limitsB = false;
+    bool sprt = false;
+    double elo0 = 0, elo1 = 5;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            if (argument == "--games" && i + 1 < argc) games = std::atoi(argv[++i]);
+            else if (argument == "--concurrency" && i + 1 < argc) concurrency = std::max(1, std::atoi(argv[++i]));
+            else if (argument == "--openings" && i + 1 < argc) openingsPath = argv[++i];
+            else if (argument == "--a" && i + 1 < argc) engineA.limits = parseLimits(argv[++i]);
+            else if (argument == "--b" && i + 1 < argc) { engineB.limits = parseLimits(argv[++i]); limitsB = true; }
+            else if (argument == "--a-params" && i + 1 < argc) engineA.parameters = parseParameters(argv[++i]);
+            else if (argument == "--b-params" && i + 1 < argc) engineB.parameters = parseParameters(argv[++i]);
+            else if (argument == "--hash" && i + 1 < argc) engineA.hashMb = engineB.hashMb = std::max(1, std::atoi(argv[++i]));
+            else if (argument == "--pgn" && i + 1 < argc) pgnPath = argv[++i];
+            else if (argument == "--sprt" && i + 2 < argc) {
+                sprt = true;
+                elo0 = std::atof(argv[++i]);
+                elo1 = std::atof(argv[++i]);
+            }
+            else {
+                printUsage();
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    if (!limitsB) {
+        engineB.limits = engineA.limits;
+    }
+
+    initAttacks();
+    // Every game searches on one thread, the games themselves are spread over the cores
+    setSearchThreads(1);
+
+    std::vector<Opening> openings;
+    try {
+        openings = loadOpenings(openingsPath);
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    if (openings.empty()) {
+        std::cerr << "No openings\n";
+        return 1;
+    }
+
+    std::ofstream pgnFile;
+    if (!pgnPath.empty()) {
+        pgnFile.open(pgnPath);
+        if (!pgnFile) {
+            std::cerr << "Unable to write " << pgnPath << '\n';
+            return 1;
+        }
+    }
+
+    int pairs = (games + 1) / 2;
+    double lowerBound = std::log(0.05 / (1 - 0.05));
+    double upperBound = std::log((1 - 0.05) / 0.05);
+
+    MatchStats stats;
+    std::mutex statsMutex;
+    std::atomic<bool> stopMatch{ false };
+    auto start = std::chrono::steady_clock::now();
+
+    // Game 2k and 2k + 1 play opening k with swapped colours. The calling thread plays games too while it waits
+    WorkStealingPool pool(concurrency - 1);
+    TaskGroup group;
+    for (int gameIndex = 0; gameIndex < pairs * 2; ++gameIndex) {
+        pool.submit(group, [&, gameIndex]() {
+            if (stopMatch.load()) {
+                return;
+            }
+            const Opening& opening = openings[(gameIndex / 2) % openings.size()];
+            bool aIsWhite = gameIndex % 2 == 0;
+            GameResult game;
+            try {
+                game = aIsWhite ? playGame(opening, engineA, engineB, true, gameIndex + 1)
+                                : playGame(opening, engineB, engineA, false, gameIndex + 1);
+            }
+            catch (const std::exception& error) {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                std::cerr << "Game " << gameIndex + 1 << ": " << error.what() << '\n';
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(statsMutex);
+            if (game.scoreA == 2) ++stats.wins;
+            else if (game.scoreA == 1) ++stats.draws;
+            else ++stats.losses;
+            if (pgnFile) {
+                pgnFile << game.pgn;
+            }
+            if (stats.games() % 10 == 0) {
+                printStats(stats);
+            }
+            if (sprt) {
+                double llr = sprtLlr(stats, elo0, elo1);
+                if (llr <= lowerBound || llr >= upperBound) {
+                    stopMatch.store(true);
+                }
+            }
+            });
+    }
+    pool.wait(group);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Finished in " << seconds << " s\n";
+    printStats(stats);
+    if (sprt) {
+        double llr = sprtLlr(stats, elo0, elo1);
+        std::cout << "SPRT elo0 " << elo0 << " elo1 " << elo1 << "  LLR: " << llr
+            << " [" << lowerBound << ", " << upperBound << "]  "
+            << (llr >= upperBound ? "H1 accepted" : llr <= lowerBound ? "H0 accepted" : "inconclusive") << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Headless move generation benchmark and correctness check.
+// Counts the leaf nodes of the legal move tree (perft) and compares them with well known reference numbers.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "engine/attacks.h"
+#include "engine/notation.h"
+#include "engine/position.h"
+#include "engine/rules.h"
+
+struct ReferencePosition {
+    std::string name;
+    std::string fen;
+    int depth;
+    uint64_t nodes;
+};
+
+// Positions and node counts from https://www.chessprogramming.org/Perft_Results
+const std::vector<ReferencePosition> referencePositions = {
+    { "Start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609 },
+    { "Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603 },
+    { "Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083 },
+    { "Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292 },
+    { "Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487 },
+    { "Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 }
+};
+
+// With bulk counting the last ply returns the number of legal moves instead of playing each of them
+uint64_t perft(Position& position, int depth, bool bulk) {
+    if (depth == 0) return 1;
+
+    MoveList moves;
+    generateAllPossibleMoves(position, position.sideToMove, moves);
+    if (bulk && depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (Move move : moves) {
+        UndoInfo undo = makeMove(position, move);
+        nodes += perft(position, depth - 1, bulk);
+        undoMove(position, move, undo);
+    }
+    return nodes;
+}
+
+// Same as perft(), but prints the node count below every root move
+uint64_t divide(Position& position, int depth, bool bulk) {
+    MoveList moves;
+    generateAllPossibleMoves(position, position.sideToMove, moves);
+
+    uint64_t nodes = 0;
+    for (Move move : moves) {
+        UndoInfo undo = makeMove(position, move);
+        uint64_t moveNodes = perft(position, depth - 1, bulk);
+        undoMove(position, move, undo);
+        std::cout << moveToString(move) << ": " << moveNodes << '\n';
+        nodes += moveNodes;
+    }
+    std::cout << "Moves: " << moves.size() << '\n';
+    return nodes;
+}
+
+void printTotals(uint64_t nodes, double seconds) {
+    std::cout << "Nodes: " << nodes
+        << "  Time: " << static_cast<int64_t>(seconds * 1000) << " ms"
+        << "  NPS: " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << '\n';
+}
+
+// Runs all reference positions and returns false if any node count is wrong
+bool runSuite(bool bulk) {
+    bool allPassed = true;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+
+    for (const auto& reference : referencePositions) {
+        Position position;
+        setFromFen(position, reference.fen);
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(position, reference.depth, bulk);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool passed = nodes == reference.nodes;
+        allPassed = allPassed && passed;
+        totalNodes += nodes;
+        totalSeconds += seconds;
+
+        std::cout << (passed ? "[ OK ] " : "[FAIL] ") << reference.name << " depth " << reference.depth
+            << ": " << nodes << " (expected " << reference.nodes << ")\n";
+    }
+
+    printTotals(totalNodes, totalSeconds);
+    return allPassed;
+}
+
+void printUsage() {
+    std::cout << "Usage: chessvsAI_perft [options]\n"
+        << "  --fen \"<fen>\"  position to count (default: start position)\n"
+        << "  --depth <n>    depth to count to (default: 5)\n"
+        << "  --divide       print the node count of every root move\n"
+        << "  --bulk         count the moves at the last ply without playing them\n"
+        << "  --suite        run the reference positions and check their node counts\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    int depth = 5;
+    bool showDivide = false;
+    bool bulk = false;
+    bool suite = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--fen" && i + 1 < argc) fen = argv[++i];
+        else if (argument == "--depth" && i + 1 < argc) depth = std::atoi(argv[++i]);
+        else if (argument == "--divide") showDivide = true;
+        else if (argument == "--bulk") bulk = true;
+        else if (argument == "--suite") suite = true;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    initAttacks();
+
+    if (suite) {
+        return runSuite(bulk) ? 0 : 1;
+    }
+
+    Position position;
+    try {
+        setFromFen(position, fen);
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = (showDivide && depth > 0) ? divide(position, depth, bulk) : perft(position, depth, bulk);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printTotals(nodes, seconds);
+    return 0;
+}
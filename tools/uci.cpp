@@ -0,0 +1,196 @@
+// Headless UCI engine.
+// Speaks the Universal Chess Interface on stdin/stdout, so the engine can be used by chess GUIs and match managers
+// without SFML, textures or a window.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "engine/async_search.h"
+#include "engine/attacks.h"
+#include "engine/notation.h"
+#include "engine/position.h"
+#include "engine/search.h"
+
+const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// The search thread prints info and bestmove lines while the main thread may answer isready, one line at a time
+std::mutex outputMutex;
+
+void sendLine(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+// UCI reports mates as the number of moves until mate, negative when the engine is getting mated
+std::string scoreToUci(int score) {
+    if (score >= mateScore - maxPly) return "mate " + std::to_string((mateScore - score + 1) / 2);
+    if (score <= -mateScore + maxPly) return "mate " + std::to_string(-(mateScore + score) / 2);
+    return "cp " + std::to_string(score);
+}
+
+void sendInfo(const SearchProgress& progress) {
+    uint64_t nps = progress.timeMs > 0 ? progress.nodes * 1000 / progress.timeMs : progress.nodes;
+    std::ostringstream line;
+    line << "info depth " << progress.depth
+        << " score " << scoreToUci(progress.score)
+        << " nodes " << progress.nodes
+        << " nps " << nps
+        << " time " << progress.timeMs
+        << " hashfull " << transpositionTable.hashfull()
+        << " pv " << moveToString(progress.bestMove);
+    sendLine(line.str());
+}
+
+// position [startpos | fen <fen>] [moves <move>...]
+void setPosition(Position& position, std::istringstream& command) {
+    std::string token;
+    command >> token;
+
+    std::string fen;
+    if (token == "startpos") {
+        fen = startFen;
+        command >> token;
+    }
+    else if (token == "fen") {
+        while (command >> token && token != "moves") {
+            fen += token + " ";
+        }
+    }
+    else {
+        return;
+    }
+
+    // An unreadable or illegal FEN throws and an illegal move returns before the current position is replaced,
+    // so go never searches a position the engine can not handle
+    Position parsed;
+    setFromFen(parsed, fen);
+    if (token == "moves") {
+        while (command >> token) {
+            Move move = parseMove(parsed, token);
+            if (move.isNone()) {
+                sendLine("info string illegal move " + token);
+                return;
+            }
+            makeMove(parsed, move);
+        }
+    }
+    position = parsed;
+}
+
+// go [depth <n>] [movetime <ms>] [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>] [movestogo <n>] [nodes <n>] [infinite]
+SearchLimits parseLimits(const Position& position, std::istringstream& command) {
+    SearchLimits limits;
+    bool white = position.sideToMove == Player::White;
+    std::string token;
+    while (command >> token) {
+        if (token == "depth") command >> limits.depth;
+        else if (token == "movetime") command >> limits.moveTimeMs;
+        else if (token == "nodes") command >> limits.nodes;
+        else if (token == "movestogo") command >> limits.movesToGo;
+        else if (token == "infinite") limits.infinite = true;
+        else if (token == "wtime" || token == "btime") {
+            int timeMs = 0;
+            command >> timeMs;
+            if ((token == "wtime") == white) limits.timeLeftMs = std::max(1, timeMs);
+        }
+        else if (token == "winc" || token == "binc") {
+            int incrementMs = 0;
+            command >> incrementMs;
+            if ((token == "winc") == white) limits.incrementMs = incrementMs;
+        }
+    }
+    return limits;
+}
+
+// setoption name <Hash | Threads> value <n>
+void setOption(std::istringstream& command) {
+    std::string token, name, value;
+    command >> token;
+    while (command >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    command >> value;
+
+    if (name == "Hash") transpositionTable.resize(std::clamp(std::atoi(value.c_str()), 1, 4096));
+    else if (name == "Threads") setSearchThreads(std::atoi(value.c_str()));
+    else sendLine("info string unknown option " + name);
+}
+
+int main() {
+    initAttacks();
+
+    Position position;
+    setFromFen(position, startFen);
+
+    // Commands that change the engine state wait for a running search to finish, only stop and quit cut it short.
+    // Every go runs on the same worker thread, which keeps its pawn table and heuristics from one move to the next
+    AsyncSearch search;
+    bool infiniteSearch = false;
+    auto waitForSearch = [&]() {
+        search.wait();
+        };
+
+    bool quit = false;
+    std::string line;
+    while (!quit && std::getline(std::cin, line)) {
+        std::istringstream command(line);
+        std::string token;
+        command >> token;
+
+        if (token == "uci") {
+            sendLine("id name chessvsAI");
+            sendLine("id author chessvsAI developers");
+            sendLine("option name Hash type spin default 16 min 1 max 4096");
+            sendLine("option name Threads type spin default 1 min 1 max 256");
+            sendLine("uciok");
+        }
+        else if (token == "isready") {
+            sendLine("readyok");
+        }
+        else if (token == "ucinewgame") {
+            waitForSearch();
+            transpositionTable.clear();
+            evalCache.clear();
+        }
+        else if (token == "setoption") {
+            waitForSearch();
+            setOption(command);
+        }
+        else if (token == "position") {
+            waitForSearch();
+            try {
+                setPosition(position, command);
+            }
+            catch (const std::exception& error) {
+                sendLine(std::string("info string ") + error.what());
+            }
+        }
+        else if (token == "go") {
+            waitForSearch();
+            SearchLimits limits = parseLimits(position, command);
+            infiniteSearch = limits.infinite;
+            search.start(position, limits, sendInfo, [](Move bestMove) {
+                sendLine("bestmove " + (bestMove.isNone() ? std::string("0000") : moveToString(bestMove)));
+                });
+        }
+        else if (token == "stop") {
+            search.stop();
+            waitForSearch();
+        }
+        else if (token == "quit") {
+            quit = true;
+        }
+    }
+
+    // At the end of piped input the last search is allowed to finish unless it would never end, quit stops it
+    if (quit || infiniteSearch) {
+        search.stop();
+    }
+    waitForSearch();
+    return 0;
+}